@@ -0,0 +1,188 @@
+#include "Augmenter.h"
+
+#include <thread>
+
+Augmenter::Augmenter(const AugmentConfig& config) : config(config), passes(0) {
+	if (config.elastic_alpha <= 0.0) {
+		return;
+	}
+
+	assert(config.elastic_sigma > 0.0);
+
+	const int radius = static_cast<int>(std::ceil(3.0 * config.elastic_sigma));
+	for (int offset = -radius; offset <= radius; ++offset) {
+		gaussian_kernel.push_back(std::exp(-(offset * offset) / (2.0 * config.elastic_sigma * config.elastic_sigma)));
+	}
+
+	const double kernel_sum = std::accumulate(gaussian_kernel.begin(), gaussian_kernel.end(), 0.0);
+	for (size_t index = 0; index < gaussian_kernel.size(); ++index) {
+		gaussian_kernel[index] /= kernel_sum;
+	}
+}
+
+std::vector<std::vector<ImageTuple>> Augmenter::augment(const std::vector<std::vector<ImageTuple>>& mini_batches, const size_t& pass) const {
+	// Flatten the batches so the work splits evenly between threads
+	std::vector<std::pair<size_t, size_t>> jobs;
+	for (size_t batch = 0; batch < mini_batches.size(); ++batch) {
+		for (size_t position = 0; position < mini_batches.at(batch).size(); ++position) {
+			jobs.push_back(std::pair<size_t, size_t>(batch, position));
+		}
+	}
+
+	std::vector<Vector> distorted(jobs.size());
+	auto work = [&](const size_t& first, const size_t& last) {
+		for (size_t job = first; job < last; ++job) {
+			const ImageTuple& image = mini_batches.at(jobs.at(job).first).at(jobs.at(job).second);
+			distort(image.image_vector, pass, distorted[job]);
+		}
+	};
+
+	const size_t thread_count = std::max<size_t>(1, std::min<size_t>(jobs.size(), (config.threads > 0) ? config.threads : std::thread::hardware_concurrency()));
+	const size_t jobs_per_thread = (jobs.size() + thread_count - 1) / thread_count;
+
+	std::vector<std::thread> workers;
+	for (size_t thread = 1; thread < thread_count; ++thread) {
+		workers.push_back(std::thread(work, std::min(jobs.size(), thread * jobs_per_thread), std::min(jobs.size(), (thread + 1) * jobs_per_thread)));
+	}
+
+	work(0, std::min(jobs.size(), jobs_per_thread));
+	for (size_t thread = 0; thread < workers.size(); ++thread) {
+		workers[thread].join();
+	}
+
+	std::vector<std::vector<ImageTuple>> result(mini_batches.size());
+	for (size_t job = 0; job < jobs.size(); ++job) {
+		result[jobs.at(job).first].push_back(make_image_tuple(distorted.at(job), mini_batches.at(jobs.at(job).first).at(jobs.at(job).second).desired_output));
+	}
+
+	return result;
+}
+
+void Augmenter::distort(const Vector& image, const size_t& pass, Vector& result) const {
+	const size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(image.size())));
+	assert(side * side == image.size());
+
+	// FNV-1a hash of the pixels identifies the image wherever the shuffle put it
+	unsigned long long image_hash = 14695981039346656037ULL;
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(image.data());
+	for (size_t index = 0; index < image.size() * sizeof(double); ++index) {
+		image_hash = (image_hash ^ bytes[index]) * 1099511628211ULL;
+	}
+
+	std::seed_seq seed{
+		config.seed,
+		static_cast<unsigned int>(pass), static_cast<unsigned int>(static_cast<unsigned long long>(pass) >> 32),
+		static_cast<unsigned int>(image_hash), static_cast<unsigned int>(image_hash >> 32)
+	};
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+	std::normal_distribution<double> noise(0.0, (config.noise_std_dev > 0.0) ? config.noise_std_dev : 1.0);
+
+	// Affine part: rotate about the centre, then shift
+	const double angle = uniform(generator) * config.max_rotation * M_PI / 180.0;
+	const double shift_x = uniform(generator) * config.max_shift;
+	const double shift_y = uniform(generator) * config.max_shift;
+	const double cos_angle = std::cos(angle);
+	const double sin_angle = std::sin(angle);
+	const double centre = (static_cast<double>(side) - 1.0) / 2.0;
+
+	// Elastic part: a random displacement per pixel, smoothed so neighbouring pixels move together.
+	// The noise covers a border as wide as the kernel, so pixels at the edge of the image average as many samples as
+	// pixels in the middle and move just as far
+	std::vector<double> displacement_x(side * side, 0.0);
+	std::vector<double> displacement_y(side * side, 0.0);
+	if (!gaussian_kernel.empty()) {
+		const size_t padded_side = side + gaussian_kernel.size() - 1;
+		std::vector<double> noise_x(padded_side * padded_side);
+		std::vector<double> noise_y(padded_side * padded_side);
+		for (size_t pixel = 0; pixel < padded_side * padded_side; ++pixel) {
+			noise_x[pixel] = uniform(generator);
+			noise_y[pixel] = uniform(generator);
+		}
+
+		smooth(noise_x, side, displacement_x);
+		smooth(noise_y, side, displacement_y);
+
+		// Rescale to unit RMS along each axis, so elastic_alpha is the RMS displacement in pixels
+		for (std::vector<double>* field : { &displacement_x, &displacement_y }) {
+			const double rms = std::sqrt(std::inner_product(field->begin(), field->end(), field->begin(), 0.0) / static_cast<double>(field->size()));
+			for (size_t pixel = 0; pixel < field->size(); ++pixel) {
+				(*field)[pixel] /= rms;
+			}
+		}
+	}
+
+	const double* source = image.data();
+	result = Vector(image.size());
+	double* destination = result.data();
+
+	for (size_t y = 0; y < side; ++y) {
+		for (size_t x = 0; x < side; ++x) {
+			const size_t pixel = y * side + x;
+
+			// Map the output pixel back to where it came from in the input
+			const double dx = static_cast<double>(x) - centre - shift_x;
+			const double dy = static_cast<double>(y) - centre - shift_y;
+			const double source_x = cos_angle * dx + sin_angle * dy + centre + config.elastic_alpha * displacement_x[pixel];
+			const double source_y = -sin_angle * dx + cos_angle * dy + centre + config.elastic_alpha * displacement_y[pixel];
+
+			const double floor_x = std::floor(source_x);
+			const double floor_y = std::floor(source_y);
+			const double fraction_x = source_x - floor_x;
+			const double fraction_y = source_y - floor_y;
+			const int x0 = static_cast<int>(floor_x);
+			const int y0 = static_cast<int>(floor_y);
+
+			// Bilinear interpolation, treating everything outside the image as background
+			double value = 0.0;
+			for (int corner = 0; corner < 4; ++corner) {
+				const int sample_x = x0 + (corner & 1);
+				const int sample_y = y0 + (corner >> 1);
+				if ((sample_x < 0) || (sample_y < 0) || (sample_x >= static_cast<int>(side)) || (sample_y >= static_cast<int>(side))) {
+					continue;
+				}
+
+				const double weight = ((corner & 1) ? fraction_x : 1.0 - fraction_x) * ((corner >> 1) ? fraction_y : 1.0 - fraction_y);
+				value += weight * source[sample_y * side + sample_x];
+			}
+
+			// Noise is only added to inked pixels, but bilinear resampling still blurs each stroke, so a distorted image has
+			// noticeably more non-zero pixels than the original and the sparse first layer does correspondingly more work
+			if ((value > 0.0) && (config.noise_std_dev > 0.0)) {
+				value += noise(generator);
+			}
+
+			destination[pixel] = std::min(255.0, std::max(0.0, value));
+		}
+	}
+}
+
+void Augmenter::smooth(const std::vector<double>& noise, const size_t& side, std::vector<double>& field) const {
+	// Separable gaussian blur of a (side + kernel size - 1) square of noise, keeping only the side x side centre where the
+	// whole kernel fits
+	const size_t width = gaussian_kernel.size();
+	const size_t padded_side = side + width - 1;
+	std::vector<double> blurred(padded_side * side);
+
+	for (size_t y = 0; y < padded_side; ++y) {
+		for (size_t x = 0; x < side; ++x) {
+			double sum = 0.0;
+			for (size_t offset = 0; offset < width; ++offset) {
+				sum += gaussian_kernel[offset] * noise[y * padded_side + x + offset];
+			}
+
+			blurred[y * side + x] = sum;
+		}
+	}
+
+	for (size_t y = 0; y < side; ++y) {
+		for (size_t x = 0; x < side; ++x) {
+			double sum = 0.0;
+			for (size_t offset = 0; offset < width; ++offset) {
+				sum += gaussian_kernel[offset] * blurred[(y + offset) * side + x];
+			}
+
+			field[y * side + x] = sum;
+		}
+	}
+}
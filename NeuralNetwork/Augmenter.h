@@ -0,0 +1,100 @@
+#ifndef AUGMENTER_H
+#define AUGMENTER_H
+#include "RequiresVector.h"
+
+#include <future>
+#include <memory>
+
+
+struct AugmentConfig {
+	double max_shift;			// Largest random translation, in pixels
+	double max_rotation;		// Largest random rotation, in degrees
+	double elastic_alpha;		// RMS displacement of the elastic distortion along each axis, in pixels (0 disables it)
+	double elastic_sigma;		// Smoothness of the elastic distortion, in pixels
+	double noise_std_dev;		// Gaussian noise added to inked pixels (0 - 255 scale)
+	unsigned int seed;			// Together with the pass number and the image's pixels, fixes every distortion
+	size_t threads;				// Worker threads per chunk of batches (0 uses every hardware thread)
+};
+
+
+// Produces randomly distorted copies of square images for each mini-batch.
+// The distortion of an image depends only on the seed, the pass over the data (how many times for_each_batch has been
+// called before) and the image's pixels, so results change neither with the thread count nor with the order the
+// training data was shuffled into.
+class Augmenter {
+public:
+	Augmenter(const AugmentConfig& config);
+
+	std::vector<std::vector<ImageTuple>> augment(const std::vector<std::vector<ImageTuple>>& mini_batches, const size_t& pass) const;
+
+	// Calls function on an augmented copy of each mini-batch in order, while the next chunk of batches is augmented in the background
+	template <typename Function>
+	void for_each_batch(const std::vector<std::vector<ImageTuple>>& mini_batches, Function function);
+
+private:
+	void distort(const Vector& image, const size_t& pass, Vector& result) const;
+	void smooth(const std::vector<double>& noise, const size_t& side, std::vector<double>& field) const;
+
+private:
+	static const size_t CHUNK_SIZE = 64;	// Mini-batches augmented per background task
+
+	AugmentConfig config;
+	std::vector<double> gaussian_kernel;
+	size_t passes;				// Calls to for_each_batch so far
+};
+
+template <typename Function>
+void Augmenter::for_each_batch(const std::vector<std::vector<ImageTuple>>& mini_batches, Function function) {
+	typedef std::vector<std::vector<ImageTuple>> Batches;
+
+	const size_t pass = passes++;
+
+	auto start_chunk = [&](const size_t& start) {
+		const Batches chunk(mini_batches.begin() + start, mini_batches.begin() + std::min(start + CHUNK_SIZE, mini_batches.size()));
+		return std::async(std::launch::async, [this, chunk, pass]() { return augment(chunk, pass); });
+	};
+
+	if (mini_batches.empty()) {
+		return;
+	}
+
+	std::future<Batches> next_chunk = start_chunk(0);
+	for (size_t start = 0; start < mini_batches.size(); start += CHUNK_SIZE) {
+		const Batches chunk = next_chunk.get();
+
+		if (start + CHUNK_SIZE < mini_batches.size()) {
+			next_chunk = start_chunk(start + CHUNK_SIZE);
+		}
+
+		for (size_t i = 0; i < chunk.size(); ++i) {
+			function(chunk.at(i));
+		}
+	}
+}
+
+// Base for networks that can train on augmented mini-batches
+class Augmentable {
+public:
+	void enable_augmentation(const AugmentConfig& augment_config) { augmenter.reset(new Augmenter(augment_config)); }
+
+protected:
+	// Calls function on each mini-batch in order, distorting it first when augmentation is enabled
+	template <typename Function>
+	void for_each_batch(const std::vector<std::vector<ImageTuple>>& mini_batches, Function function);
+
+private:
+	std::unique_ptr<Augmenter> augmenter;		// Distorts training mini-batches when set
+};
+
+template <typename Function>
+void Augmentable::for_each_batch(const std::vector<std::vector<ImageTuple>>& mini_batches, Function function) {
+	if (augmenter) {
+		augmenter->for_each_batch(mini_batches, function);
+	} else {
+		for (size_t i = 0; i < mini_batches.size(); ++i) {
+			function(mini_batches.at(i));
+		}
+	}
+}
+
+#endif
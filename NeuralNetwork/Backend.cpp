@@ -0,0 +1,443 @@
+#include "Backend.h"
+
+#include <thread>
+#include <cstdlib>
+
+#ifdef USE_CBLAS
+#include <cblas.h>
+#endif
+
+//
+//
+//	Backend Selection
+//
+//
+
+std::vector<std::unique_ptr<Backend>>& Backend::registry() {
+	static std::vector<std::unique_ptr<Backend>> backends = []() {
+		std::vector<std::unique_ptr<Backend>> all;
+		all.push_back(std::unique_ptr<Backend>(new ReferenceBackend()));
+		all.push_back(std::unique_ptr<Backend>(new BlockedBackend()));
+#ifdef USE_CBLAS
+		all.push_back(std::unique_ptr<Backend>(new BlasBackend()));
+#endif
+		return all;
+	}();
+
+	return backends;
+}
+
+const Backend*& Backend::current() {
+	static const Backend* backend = []() -> const Backend* {
+		const char* requested = std::getenv("NN_BACKEND");
+		for (size_t index = 0; (requested != nullptr) && (index < registry().size()); ++index) {
+			if (registry().at(index)->name() == requested) {
+				return registry().at(index).get();
+			}
+		}
+
+		if (requested != nullptr) {
+			std::cout << "Unknown backend " << requested << ", using blocked" << std::endl;
+		}
+
+		return registry().at(1).get();
+	}();
+
+	return backend;
+}
+
+const Backend* Backend::get() {
+	return current();
+}
+
+void Backend::set(const std::string& name) {
+	for (size_t index = 0; index < registry().size(); ++index) {
+		if (registry().at(index)->name() == name) {
+			current() = registry().at(index).get();
+			return;
+		}
+	}
+
+	throw std::runtime_error("Unknown backend " + name);
+}
+
+std::vector<std::string> Backend::names() {
+	std::vector<std::string> result;
+	for (size_t index = 0; index < registry().size(); ++index) {
+		result.push_back(registry().at(index)->name());
+	}
+
+	return result;
+}
+
+bool Backend::cross_check(const double& tolerance) {
+	const Backend& reference = *registry().at(0);
+
+	// Odd sizes exercise the edges of every block and register tile, and the last shape is big enough for gemv and ger
+	// (not just gemm) to be split between threads
+	const size_t shapes[][3] = { { 1, 1, 1 }, { 3, 5, 7 }, { 64, 784, 1 }, { 10, 64, 64 }, { 70, 530, 300 }, { 257, 129, 65 }, { 1024, 1025, 3 } };
+
+	auto random_values = [](const size_t& count) {
+		std::vector<double> values(count);
+		for (size_t index = 0; index < count; ++index) {
+			values[index] = Random::get_gaussian_distribution(0.0, 1.0);
+		}
+
+		return values;
+	};
+
+	auto difference = [](const std::vector<double>& a, const std::vector<double>& b) {
+		double largest = 0.0;
+		for (size_t index = 0; index < a.size(); ++index) {
+			largest = std::max(largest, std::abs(a[index] - b[index]) / std::max(1.0, std::abs(b[index])));
+		}
+
+		return largest;
+	};
+
+	// The threaded paths are also checked with a fixed thread count, so they run even on a single core machine
+	BlockedBackend threaded(4);
+
+	std::vector<std::pair<const Backend*, std::string>> candidates;
+	for (size_t backend = 1; backend < registry().size(); ++backend) {
+		candidates.push_back(std::make_pair(registry().at(backend).get(), registry().at(backend)->name()));
+	}
+	candidates.push_back(std::make_pair(&threaded, threaded.name() + " (4 threads)"));
+
+	bool passed = true;
+	for (size_t index = 0; index < candidates.size(); ++index) {
+		const Backend& candidate = *candidates.at(index).first;
+		double largest = 0.0;
+
+		for (const size_t (&shape)[3] : shapes) {
+			const size_t M = shape[0], N = shape[1], K = shape[2];
+
+			for (int transpose = 0; transpose < 2; ++transpose) {
+				const std::vector<double> A = random_values(M * N);
+				const std::vector<double> x = random_values(transpose ? M : N);
+				std::vector<double> y = random_values(transpose ? N : M);
+				std::vector<double> expected = y;
+
+				candidate.gemv(transpose == 1, M, N, 0.5, A.data(), N, x.data(), 2.0, y.data());
+				reference.gemv(transpose == 1, M, N, 0.5, A.data(), N, x.data(), 2.0, expected.data());
+				largest = std::max(largest, difference(y, expected));
+			}
+
+			for (int transposes = 0; transposes < 4; ++transposes) {
+				const bool transpose_a = (transposes & 1) != 0;
+				const bool transpose_b = (transposes & 2) != 0;
+				const std::vector<double> A = random_values(M * K);
+				const std::vector<double> B = random_values(K * N);
+				std::vector<double> C = random_values(M * N);
+				std::vector<double> expected = C;
+
+				candidate.gemm(transpose_a, transpose_b, M, N, K, 0.5, A.data(), transpose_a ? M : K, B.data(), transpose_b ? K : N, 2.0, C.data(), N);
+				reference.gemm(transpose_a, transpose_b, M, N, K, 0.5, A.data(), transpose_a ? M : K, B.data(), transpose_b ? K : N, 2.0, expected.data(), N);
+				largest = std::max(largest, difference(C, expected));
+			}
+
+			const std::vector<double> x = random_values(M);
+			const std::vector<double> y = random_values(N);
+			std::vector<double> A = random_values(M * N);
+			std::vector<double> expected = A;
+
+			candidate.ger(M, N, 0.5, x.data(), y.data(), A.data(), N);
+			reference.ger(M, N, 0.5, x.data(), y.data(), expected.data(), N);
+			largest = std::max(largest, difference(A, expected));
+		}
+
+		std::cout << candidates.at(index).second << ": largest relative difference from reference = " << largest << std::endl;
+		passed = passed && (largest <= tolerance);
+	}
+
+	return passed;
+}
+
+//
+//
+//	ReferenceBackend
+//
+//
+
+void ReferenceBackend::gemv(const bool& transpose, const size_t& M, const size_t& N, const double& alpha, const double* A, const size_t& lda, const double* x, const double& beta, double* y) const {
+	const size_t outputs = transpose ? N : M;
+	const size_t inputs = transpose ? M : N;
+
+	for (size_t i = 0; i < outputs; ++i) {
+		double sum = 0.0;
+		for (size_t j = 0; j < inputs; ++j) {
+			sum += (transpose ? A[j * lda + i] : A[i * lda + j]) * x[j];
+		}
+
+		y[i] = alpha * sum + ((beta == 0.0) ? 0.0 : beta * y[i]);
+	}
+}
+
+void ReferenceBackend::gemm(const bool& transpose_a, const bool& transpose_b, const size_t& M, const size_t& N, const size_t& K, const double& alpha, const double* A, const size_t& lda, const double* B, const size_t& ldb, const double& beta, double* C, const size_t& ldc) const {
+	for (size_t i = 0; i < M; ++i) {
+		for (size_t j = 0; j < N; ++j) {
+			double sum = 0.0;
+			for (size_t p = 0; p < K; ++p) {
+				sum += (transpose_a ? A[p * lda + i] : A[i * lda + p]) * (transpose_b ? B[j * ldb + p] : B[p * ldb + j]);
+			}
+
+			C[i * ldc + j] = alpha * sum + ((beta == 0.0) ? 0.0 : beta * C[i * ldc + j]);
+		}
+	}
+}
+
+void ReferenceBackend::ger(const size_t& M, const size_t& N, const double& alpha, const double* x, const double* y, double* A, const size_t& lda) const {
+	for (size_t i = 0; i < M; ++i) {
+		for (size_t j = 0; j < N; ++j) {
+			A[i * lda + j] += alpha * x[i] * y[j];
+		}
+	}
+}
+
+//
+//
+//	BlockedBackend
+//
+//
+
+// Problems below this many floating point operations run on the calling thread, since waking the pool's workers (tens of
+// microseconds) would cost more than the work saved
+static const double PARALLEL_FLOPS = 1 << 18;
+
+// Register tile: an MR x NR block of C is kept in local accumulators across the whole inner dimension
+static const size_t MR = 4;
+static const size_t NR = 4;
+
+// Cache blocks: a packed MC x KC block of A stays in L2, a packed KC x NR panel of B stays in L1
+static const size_t MC = 64;
+static const size_t KC = 256;
+static const size_t NC = 512;
+
+BlockedBackend::BlockedBackend(const size_t& threads) : pool(new ThreadPool((threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency()))) {}
+
+template <typename Work>
+void BlockedBackend::parallel_for(const size_t& count, const double& flops, Work work) const {
+	const size_t threads = std::min(pool->size(), count);
+	if ((threads <= 1) || (flops < PARALLEL_FLOPS)) {
+		work(0, count);
+		return;
+	}
+
+	const size_t per_thread = (count + threads - 1) / threads;
+
+	pool->run(threads, [&](const size_t& thread) {
+		const size_t first = std::min(count, thread * per_thread);
+		const size_t last = std::min(count, first + per_thread);
+
+		if (first < last) {
+			work(first, last);
+		}
+	});
+}
+
+void BlockedBackend::gemv(const bool& transpose, const size_t& M, const size_t& N, const double& alpha, const double* A, const size_t& lda, const double* x, const double& beta, double* y) const {
+	const double flops = 2.0 * M * N;
+
+	if (!transpose) {
+		// Four rows at a time share each load of x
+		parallel_for(M, flops, [&](const size_t& first, const size_t& last) {
+			size_t i = first;
+			for (; i + 4 <= last; i += 4) {
+				const double* row_0 = A + i * lda;
+				const double* row_1 = row_0 + lda;
+				const double* row_2 = row_1 + lda;
+				const double* row_3 = row_2 + lda;
+
+				double sum_0 = 0.0, sum_1 = 0.0, sum_2 = 0.0, sum_3 = 0.0;
+				for (size_t j = 0; j < N; ++j) {
+					sum_0 += row_0[j] * x[j];
+					sum_1 += row_1[j] * x[j];
+					sum_2 += row_2[j] * x[j];
+					sum_3 += row_3[j] * x[j];
+				}
+
+				const double sums[4] = { sum_0, sum_1, sum_2, sum_3 };
+				for (size_t r = 0; r < 4; ++r) {
+					y[i + r] = alpha * sums[r] + ((beta == 0.0) ? 0.0 : beta * y[i + r]);
+				}
+			}
+
+			for (; i < last; ++i) {
+				const double* row = A + i * lda;
+
+				double sum = 0.0;
+				for (size_t j = 0; j < N; ++j) {
+					sum += row[j] * x[j];
+				}
+
+				y[i] = alpha * sum + ((beta == 0.0) ? 0.0 : beta * y[i]);
+			}
+		});
+
+		return;
+	}
+
+	// Transposed: each thread owns a range of y and sweeps the rows of A four at a time, so every read is contiguous
+	parallel_for(N, flops, [&](const size_t& first, const size_t& last) {
+		for (size_t j = first; j < last; ++j) {
+			y[j] = (beta == 0.0) ? 0.0 : beta * y[j];
+		}
+
+		size_t i = 0;
+		for (; i + 4 <= M; i += 4) {
+			const double* row_0 = A + i * lda;
+			const double* row_1 = row_0 + lda;
+			const double* row_2 = row_1 + lda;
+			const double* row_3 = row_2 + lda;
+			const double scale_0 = alpha * x[i], scale_1 = alpha * x[i + 1], scale_2 = alpha * x[i + 2], scale_3 = alpha * x[i + 3];
+
+			for (size_t j = first; j < last; ++j) {
+				y[j] += scale_0 * row_0[j] + scale_1 * row_1[j] + scale_2 * row_2[j] + scale_3 * row_3[j];
+			}
+		}
+
+		for (; i < M; ++i) {
+			const double* row = A + i * lda;
+			const double scale = alpha * x[i];
+
+			for (size_t j = first; j < last; ++j) {
+				y[j] += scale * row[j];
+			}
+		}
+	});
+}
+
+void BlockedBackend::gemm(const bool& transpose_a, const bool& transpose_b, const size_t& M, const size_t& N, const size_t& K, const double& alpha, const double* A, const size_t& lda, const double* B, const size_t& ldb, const double& beta, double* C, const size_t& ldc) const {
+	// Each thread computes a band of rows of C, so no two threads write the same element
+	parallel_for(M, 2.0 * M * N * K, [&](const size_t& first, const size_t& last) {
+		for (size_t i = first; i < last; ++i) {
+			for (size_t j = 0; j < N; ++j) {
+				C[i * ldc + j] = (beta == 0.0) ? 0.0 : beta * C[i * ldc + j];
+			}
+		}
+
+		if ((alpha != 0.0) && (K > 0) && (first < last)) {
+			const double* A_band = transpose_a ? A + first : A + first * lda;
+			gemm_block(transpose_a, transpose_b, last - first, N, K, alpha, A_band, lda, B, ldb, C + first * ldc, ldc);
+		}
+	});
+}
+
+void BlockedBackend::gemm_block(const bool& transpose_a, const bool& transpose_b, const size_t& M, const size_t& N, const size_t& K, const double& alpha, const double* A, const size_t& lda, const double* B, const size_t& ldb, double* C, const size_t& ldc) const {
+	// C += alpha * op(A) * op(B)
+	// Tiles of op(A) and op(B) are packed into panels (zero padded to whole register tiles), so the micro-kernel reads
+	// both with unit stride whatever the original layout
+	const size_t packed_rows = ((std::min(MC, M) + MR - 1) / MR) * MR;
+	const size_t packed_cols = ((std::min(NC, N) + NR - 1) / NR) * NR;
+	std::vector<double> packed_A(packed_rows * std::min(KC, K));
+	std::vector<double> packed_B(packed_cols * std::min(KC, K));
+
+	for (size_t j0 = 0; j0 < N; j0 += NC) {
+		const size_t n_block = std::min(NC, N - j0);
+
+		for (size_t p0 = 0; p0 < K; p0 += KC) {
+			const size_t k_block = std::min(KC, K - p0);
+
+			// packed_B: for each panel of NR columns, k_block rows of NR values
+			for (size_t jp = 0; jp < n_block; jp += NR) {
+				double* panel = packed_B.data() + jp * k_block;
+
+				for (size_t p = 0; p < k_block; ++p) {
+					for (size_t c = 0; c < NR; ++c) {
+						const size_t j = j0 + jp + c;
+						panel[p * NR + c] = (jp + c >= n_block) ? 0.0 : (transpose_b ? B[j * ldb + (p0 + p)] : B[(p0 + p) * ldb + j]);
+					}
+				}
+			}
+
+			for (size_t i0 = 0; i0 < M; i0 += MC) {
+				const size_t m_block = std::min(MC, M - i0);
+
+				// packed_A: for each panel of MR rows, k_block columns of MR values, with alpha folded in
+				for (size_t ip = 0; ip < m_block; ip += MR) {
+					double* panel = packed_A.data() + ip * k_block;
+
+					for (size_t p = 0; p < k_block; ++p) {
+						for (size_t r = 0; r < MR; ++r) {
+							const size_t i = i0 + ip + r;
+							panel[p * MR + r] = (ip + r >= m_block) ? 0.0 : alpha * (transpose_a ? A[(p0 + p) * lda + i] : A[i * lda + (p0 + p)]);
+						}
+					}
+				}
+
+				// Micro-kernel: one MR x NR tile of C per pair of panels
+				for (size_t ip = 0; ip < m_block; ip += MR) {
+					const double* A_panel = packed_A.data() + ip * k_block;
+					const size_t rows = std::min(MR, m_block - ip);
+
+					for (size_t jp = 0; jp < n_block; jp += NR) {
+						const double* B_panel = packed_B.data() + jp * k_block;
+						const size_t cols = std::min(NR, n_block - jp);
+
+						double tile[MR][NR] = {};
+						for (size_t p = 0; p < k_block; ++p) {
+							const double* a = A_panel + p * MR;
+							const double* b = B_panel + p * NR;
+
+							for (size_t r = 0; r < MR; ++r) {
+								for (size_t c = 0; c < NR; ++c) {
+									tile[r][c] += a[r] * b[c];
+								}
+							}
+						}
+
+						for (size_t r = 0; r < rows; ++r) {
+							double* C_row = C + (i0 + ip + r) * ldc + j0 + jp;
+							for (size_t c = 0; c < cols; ++c) {
+								C_row[c] += tile[r][c];
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void BlockedBackend::ger(const size_t& M, const size_t& N, const double& alpha, const double* x, const double* y, double* A, const size_t& lda) const {
+	parallel_for(M, 2.0 * M * N, [&](const size_t& first, const size_t& last) {
+		for (size_t i = first; i < last; ++i) {
+			const double scale = alpha * x[i];
+			double* row = A + i * lda;
+
+			for (size_t j = 0; j < N; ++j) {
+				row[j] += scale * y[j];
+			}
+		}
+	});
+}
+
+//
+//
+//	BlasBackend
+//
+//
+
+#ifdef USE_CBLAS
+void BlasBackend::gemv(const bool& transpose, const size_t& M, const size_t& N, const double& alpha, const double* A, const size_t& lda, const double* x, const double& beta, double* y) const {
+	cblas_dgemv(
+		CblasRowMajor, transpose ? CblasTrans : CblasNoTrans,
+		static_cast<int>(M), static_cast<int>(N),
+		alpha, A, static_cast<int>(lda), x, 1,
+		beta, y, 1
+	);
+}
+
+void BlasBackend::gemm(const bool& transpose_a, const bool& transpose_b, const size_t& M, const size_t& N, const size_t& K, const double& alpha, const double* A, const size_t& lda, const double* B, const size_t& ldb, const double& beta, double* C, const size_t& ldc) const {
+	cblas_dgemm(
+		CblasRowMajor, transpose_a ? CblasTrans : CblasNoTrans, transpose_b ? CblasTrans : CblasNoTrans,
+		static_cast<int>(M), static_cast<int>(N), static_cast<int>(K),
+		alpha, A, static_cast<int>(lda), B, static_cast<int>(ldb),
+		beta, C, static_cast<int>(ldc)
+	);
+}
+
+void BlasBackend::ger(const size_t& M, const size_t& N, const double& alpha, const double* x, const double* y, double* A, const size_t& lda) const {
+	cblas_dger(CblasRowMajor, static_cast<int>(M), static_cast<int>(N), alpha, x, 1, y, 1, A, static_cast<int>(lda));
+}
+#endif
@@ -0,0 +1,98 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+#include <vector>
+#include <string>
+#include <memory>
+#include "Helpers.h"
+#include "ThreadPool.h"
+
+// Dense linear algebra used by Matrix, Vector and the convolution layers.
+// All matrices are row-major with the given leading dimension (distance between the starts of two rows).
+//
+// Backends are chosen at runtime with Backend::set or the NN_BACKEND environment variable:
+//	"reference"	Plain loops, used to cross-check the others
+//	"blocked"	Cache-blocked, register-tiled and multithreaded (default)
+//	"cblas"		System CBLAS such as OpenBLAS, when built with USE_CBLAS defined and linked against it
+class Backend {
+public:
+	virtual ~Backend() {}
+
+	virtual std::string name() const = 0;
+
+	// y (M or N) = alpha * op(A) * x + beta * y, where A is M x N and op(A) is A or its transpose
+	virtual void gemv(
+		const bool& transpose, const size_t& M, const size_t& N,
+		const double& alpha, const double* A, const size_t& lda, const double* x,
+		const double& beta, double* y
+	) const = 0;
+
+	// C (M x N) = alpha * op(A) * op(B) + beta * C, where op(A) is M x K and op(B) is K x N
+	virtual void gemm(
+		const bool& transpose_a, const bool& transpose_b,
+		const size_t& M, const size_t& N, const size_t& K,
+		const double& alpha, const double* A, const size_t& lda, const double* B, const size_t& ldb,
+		const double& beta, double* C, const size_t& ldc
+	) const = 0;
+
+	// A (M x N) += alpha * x * y^T
+	virtual void ger(const size_t& M, const size_t& N, const double& alpha, const double* x, const double* y, double* A, const size_t& lda) const = 0;
+
+public:
+	static const Backend* get();
+	static void set(const std::string& name);
+	static std::vector<std::string> names();
+
+	// Runs every backend on random problems and prints its largest difference from the reference backend
+	static bool cross_check(const double& tolerance);
+
+private:
+	static std::vector<std::unique_ptr<Backend>>& registry();
+	static const Backend*& current();
+};
+
+
+class ReferenceBackend : public Backend {
+public:
+	std::string name() const { return "reference"; }
+
+	void gemv(const bool& transpose, const size_t& M, const size_t& N, const double& alpha, const double* A, const size_t& lda, const double* x, const double& beta, double* y) const;
+	void gemm(const bool& transpose_a, const bool& transpose_b, const size_t& M, const size_t& N, const size_t& K, const double& alpha, const double* A, const size_t& lda, const double* B, const size_t& ldb, const double& beta, double* C, const size_t& ldc) const;
+	void ger(const size_t& M, const size_t& N, const double& alpha, const double* x, const double* y, double* A, const size_t& lda) const;
+};
+
+
+class BlockedBackend : public Backend {
+public:
+	// threads = 0 uses every hardware thread
+	BlockedBackend(const size_t& threads = 0);
+
+	std::string name() const { return "blocked"; }
+
+	void gemv(const bool& transpose, const size_t& M, const size_t& N, const double& alpha, const double* A, const size_t& lda, const double* x, const double& beta, double* y) const;
+	void gemm(const bool& transpose_a, const bool& transpose_b, const size_t& M, const size_t& N, const size_t& K, const double& alpha, const double* A, const size_t& lda, const double* B, const size_t& ldb, const double& beta, double* C, const size_t& ldc) const;
+	void ger(const size_t& M, const size_t& N, const double& alpha, const double* x, const double* y, double* A, const size_t& lda) const;
+
+private:
+	// Runs work(first, last) over [0, count) split between the pool's threads, or inline if the problem is too small to be worth it
+	template <typename Work>
+	void parallel_for(const size_t& count, const double& flops, Work work) const;
+
+	void gemm_block(const bool& transpose_a, const bool& transpose_b, const size_t& M, const size_t& N, const size_t& K, const double& alpha, const double* A, const size_t& lda, const double* B, const size_t& ldb, double* C, const size_t& ldc) const;
+
+private:
+	std::unique_ptr<ThreadPool> pool;
+};
+
+
+#ifdef USE_CBLAS
+class BlasBackend : public Backend {
+public:
+	std::string name() const { return "cblas"; }
+
+	void gemv(const bool& transpose, const size_t& M, const size_t& N, const double& alpha, const double* A, const size_t& lda, const double* x, const double& beta, double* y) const;
+	void gemm(const bool& transpose_a, const bool& transpose_b, const size_t& M, const size_t& N, const size_t& K, const double& alpha, const double* A, const size_t& lda, const double* B, const size_t& ldb, const double& beta, double* C, const size_t& ldc) const;
+	void ger(const size_t& M, const size_t& N, const double& alpha, const double* x, const double* y, double* A, const size_t& lda) const;
+};
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+#include "ConvNetwork.h"
+
+void ConvNetwork::add_layer(Layer* layer) {
+	assert(layers.empty() || (layers.back()->output_size() == layer->input_size()));
+	layers.push_back(std::unique_ptr<Layer>(layer));
+}
+
+Vector ConvNetwork::feedforward(Vector activations) {
+	// Returns the output of the network
+	for (size_t layer = 0; layer < layers.size(); ++layer) {
+		activations = layers.at(layer)->forward(activations);
+	}
+
+	return activations;
+}
+
+void ConvNetwork::train(std::vector<ImageTuple> training, const std::vector<ImageTuple>&, const std::vector<ImageTuple>& validation) {
+	assert((layers.size() > 1) && (dynamic_cast<SigmoidLayer*>(layers.back().get()) != nullptr));
+
+	for (size_t epoch = 0; epoch < config.epochs; ++epoch) {
+		Random::shuffle<ImageTuple>(training);
+		const std::vector<std::vector<ImageTuple>> mini_batches = split_training_data(training, config.mini_batch_size);
+
+		for_each_batch(mini_batches, [&](const std::vector<ImageTuple>& mini_batch) {
+			update_mini_batch(mini_batch, training.size());
+		});
+
+		std::pair<size_t, double> training_evaluation = evaluate(training);
+		std::pair<size_t, double> validation_evaluation = evaluate(validation);
+
+		std::cout << "Epoch " << epoch + 1 << " of " << config.epochs << ": " << std::endl;
+		print_evaluation("Training", training_evaluation, training.size());
+		print_evaluation("Validation", validation_evaluation, validation.size());
+		std::cout << std::endl;
+	}
+
+	std::cout << "Finished" << std::endl;
+}
+
+std::pair<size_t, double> ConvNetwork::evaluate(const std::vector<ImageTuple>& data) {
+	size_t correct = 0;
+	double summed_cost = 0.0;
+
+	for (size_t i = 0; i < data.size(); ++i) {
+		size_t desired_output_value = get_highest_index(data.at(i).desired_output);
+		Vector actual_output = feedforward(data.at(i).image_vector);
+
+		if (desired_output_value == get_highest_index(actual_output)) {
+			correct++;
+		}
+
+		summed_cost += config.cost_function.function(actual_output, data.at(i).desired_output);
+	}
+
+	return std::pair<size_t, double>(correct, summed_cost / static_cast<double>(data.size()));
+}
+
+void ConvNetwork::update_mini_batch(const std::vector<ImageTuple>& mini_batch, const size_t& training_size) {
+	// Each layer accumulates its own gradients during backprop
+	for (size_t i = 0; i < mini_batch.size(); ++i) {
+		backprop(mini_batch.at(i));
+	}
+
+	const double learning_constant = config.eta / static_cast<double>(mini_batch.size());
+	const double regularisation_constant = (1.0 - (config.eta * config.lambda / static_cast<double>(training_size)));
+	for (size_t layer = 0; layer < layers.size(); ++layer) {
+		layers.at(layer)->update(learning_constant, regularisation_constant);
+	}
+}
+
+void ConvNetwork::backprop(const ImageTuple& image) {
+	const size_t output_layer = layers.size() - 1;
+
+	// Step 1: Feedforward up to the output sigmoid, keeping its input z for the cost function
+	Vector z_values = image.image_vector;
+	for (size_t layer = 0; layer < output_layer; ++layer) {
+		z_values = layers.at(layer)->forward(z_values);
+	}
+
+	const Vector activations = layers.at(output_layer)->forward(z_values);
+
+	// Step 2: Output Error (dC/dz of the output sigmoid)
+	Vector delta = config.cost_function.bias_derivative(z_values, activations, image.desired_output);
+
+	// Step 3: Backpropagate the Error, skipping the input gradient of the first layer since nothing uses it
+	for (size_t layer = output_layer; layer-- > 0;) {
+		delta = layers.at(layer)->backward(delta, layer > 0);
+	}
+}
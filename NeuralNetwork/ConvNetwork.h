@@ -0,0 +1,30 @@
+#ifndef CONVNETWORK_H
+#define CONVNETWORK_H
+#include "Network.h"
+#include "Layer.h"
+
+
+// A network built from a stack of Layer objects, so convolution and pooling layers can sit next to dense ones.
+// The last layer must be a SigmoidLayer, whose input is the z used by the cost function's bias derivative.
+class ConvNetwork : public Augmentable {
+public:
+	ConvNetwork(const NetworkConfig& config) : config(config) {}
+
+	// Takes ownership of layer
+	void add_layer(Layer* layer);
+
+	void train(std::vector<ImageTuple> training, const std::vector<ImageTuple>& test, const std::vector<ImageTuple>& validation);
+
+private:
+	Vector feedforward(Vector activations);
+	std::pair<size_t, double> evaluate(const std::vector<ImageTuple>& data);
+
+	void update_mini_batch(const std::vector<ImageTuple>& mini_batch, const size_t& training_size);
+	void backprop(const ImageTuple& image);
+
+private:
+	NetworkConfig config;
+	std::vector<std::unique_ptr<Layer>> layers;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef DOUBLEBUFFER_H
+#define DOUBLEBUFFER_H
+#include <atomic>
+#include <thread>
+#include <utility>
+
+// Holds two copies of a value: readers use the front copy while a single writer fills the back one and then swaps them.
+// Readers never wait on the writer; they only retry if a swap happens between choosing a copy and registering on it.
+template <typename T>
+class DoubleBuffer {
+public:
+	DoubleBuffer(const DoubleBuffer& other) = delete;
+	DoubleBuffer& operator=(const DoubleBuffer& other) = delete;
+
+	DoubleBuffer() : front(0) {
+		readers[0] = 0;
+		readers[1] = 0;
+	}
+
+	// Calls function with the current front copy, which will not change until function returns
+	template <typename Function>
+	auto read(Function function) const -> decltype(function(std::declval<const T&>())) {
+		size_t index;
+
+		while (true) {
+			index = front.load();
+			readers[index]++;
+
+			if (front.load() == index) {
+				break;
+			}
+
+			// The writer swapped before this reader registered, so the copy may be overwritten
+			readers[index]--;
+		}
+
+		ReadGuard guard(readers[index]);
+		return function(buffers[index]);
+	}
+
+	// Only one thread may publish at a time
+	void publish(const T& value) {
+		const size_t back = 1 - front.load();
+
+		// Readers still on the back copy registered before the previous swap
+		while (readers[back].load() != 0) {
+			std::this_thread::yield();
+		}
+
+		buffers[back] = value;
+		front.store(back);
+	}
+
+private:
+	struct ReadGuard {
+		std::atomic<size_t>& count;
+
+		ReadGuard(std::atomic<size_t>& count) : count(count) {}
+		~ReadGuard() { count--; }
+	};
+
+	T buffers[2];
+	std::atomic<size_t> front;
+	mutable std::atomic<size_t> readers[2];
+};
+
+#endif
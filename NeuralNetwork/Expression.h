@@ -0,0 +1,213 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+#include <vector>
+#include "Helpers.h"
+
+//
+//
+//	Expression Templates
+//
+//
+
+// Arithmetic on Vector and Matrix returns lightweight expression objects instead of results. Nothing is computed until an
+// expression is assigned to a Vector or Matrix, which then evaluates the whole chain in one loop into its own storage:
+//
+//	weights[layer] = (weights.at(layer) * regularisation_constant) - (nabla_W.at(layer) * learning_constant);
+//
+// runs as a single pass over weights with no temporary matrices.
+// Expressions hold references to their Vector and Matrix operands, so they must be assigned within the same statement
+// (never stored with auto).
+// Matrix-vector products are the exception to element-by-element evaluation: a Vector being assigned binds its own
+// storage to the product first (see bind), so the gemv writes straight into it and the rest of the loop reads it in place.
+
+class Vector;
+class Matrix;
+
+// Vector and Matrix operands are held by reference, nested expressions by value
+template <typename E> struct Operand { typedef const E type; };
+template <> struct Operand<Vector> { typedef const Vector& type; };
+template <> struct Operand<Matrix> { typedef const Matrix& type; };
+
+template <typename E>
+class VectorExpression {
+public:
+	typedef std::vector<double>::size_type size_type;
+
+	inline const E& self() const { return static_cast<const E&>(*this); }
+
+	inline size_type size() const { return self().size(); }
+	inline double operator[](const size_type& index) const { return self()[index]; }
+
+	// True if writing element i of destination could change another element this expression still has to read
+	inline bool aliases(const void* destination) const { return self().aliases(destination); }
+	// True if destination is read anywhere in this expression
+	inline bool reads(const void* destination) const { return self().reads(destination); }
+	// Lets one matrix product write its result straight into destination; true once a product has done so
+	inline bool bind(double* destination) const { return self().bind(destination); }
+
+	double magnitude() const {
+		double sum_of_squares = 0.0;
+		for (size_type index = 0; index < size(); ++index) {
+			const double value = (*this)[index];
+			sum_of_squares += value * value;
+		}
+
+		return std::sqrt(sum_of_squares);
+	}
+};
+
+template <typename E>
+class MatrixExpression {
+public:
+	typedef std::vector<double>::size_type size_type;
+
+	inline const E& self() const { return static_cast<const E&>(*this); }
+
+	inline size_type row_count() const { return self().row_count(); }
+	inline size_type column_count() const { return self().column_count(); }
+	inline double operator()(const size_type& row, const size_type& col) const { return self()(row, col); }
+
+	inline bool aliases(const void* destination) const { return self().aliases(destination); }
+};
+
+//
+//
+//	Element-wise Operations
+//
+//
+
+struct Add { static inline double apply(const double& a, const double& b) { return a + b; } };
+struct Subtract { static inline double apply(const double& a, const double& b) { return a - b; } };
+struct Multiply { static inline double apply(const double& a, const double& b) { return a * b; } };
+
+template <typename L, typename R, typename Operation>
+class VectorBinary : public VectorExpression<VectorBinary<L, R, Operation>> {
+public:
+	typedef std::vector<double>::size_type size_type;
+
+	VectorBinary(const L& left, const R& right) : left(left), right(right) { assert(left.size() == right.size()); }
+
+	inline size_type size() const { return left.size(); }
+	inline double operator[](const size_type& index) const { return Operation::apply(left[index], right[index]); }
+	inline bool aliases(const void* destination) const { return left.aliases(destination) || right.aliases(destination); }
+	inline bool reads(const void* destination) const { return left.reads(destination) || right.reads(destination); }
+	inline bool bind(double* destination) const { return left.bind(destination) || right.bind(destination); }
+
+private:
+	typename Operand<L>::type left;
+	typename Operand<R>::type right;
+};
+
+template <typename E>
+class VectorScale : public VectorExpression<VectorScale<E>> {
+public:
+	typedef std::vector<double>::size_type size_type;
+
+	VectorScale(const E& vector, const double& scalar) : vector(vector), scalar(scalar) {}
+
+	inline size_type size() const { return vector.size(); }
+	inline double operator[](const size_type& index) const { return vector[index] * scalar; }
+	inline bool aliases(const void* destination) const { return vector.aliases(destination); }
+	inline bool reads(const void* destination) const { return vector.reads(destination); }
+	inline bool bind(double* destination) const { return vector.bind(destination); }
+
+private:
+	typename Operand<E>::type vector;
+	double scalar;
+};
+
+template <typename E, double (*Function)(const double&)>
+class VectorApply : public VectorExpression<VectorApply<E, Function>> {
+public:
+	typedef std::vector<double>::size_type size_type;
+
+	VectorApply(const E& vector) : vector(vector) {}
+
+	inline size_type size() const { return vector.size(); }
+	inline double operator[](const size_type& index) const { return Function(vector[index]); }
+	inline bool aliases(const void* destination) const { return vector.aliases(destination); }
+	inline bool reads(const void* destination) const { return vector.reads(destination); }
+	inline bool bind(double* destination) const { return vector.bind(destination); }
+
+private:
+	typename Operand<E>::type vector;
+};
+
+template <typename L, typename R, typename Operation>
+class MatrixBinary : public MatrixExpression<MatrixBinary<L, R, Operation>> {
+public:
+	typedef std::vector<double>::size_type size_type;
+
+	MatrixBinary(const L& left, const R& right) : left(left), right(right) {
+		assert((left.row_count() == right.row_count()) && (left.column_count() == right.column_count()));
+	}
+
+	inline size_type row_count() const { return left.row_count(); }
+	inline size_type column_count() const { return left.column_count(); }
+	inline double operator()(const size_type& row, const size_type& col) const { return Operation::apply(left(row, col), right(row, col)); }
+	inline bool aliases(const void* destination) const { return left.aliases(destination) || right.aliases(destination); }
+
+private:
+	typename Operand<L>::type left;
+	typename Operand<R>::type right;
+};
+
+template <typename E>
+class MatrixScale : public MatrixExpression<MatrixScale<E>> {
+public:
+	typedef std::vector<double>::size_type size_type;
+
+	MatrixScale(const E& matrix, const double& scalar) : matrix(matrix), scalar(scalar) {}
+
+	inline size_type row_count() const { return matrix.row_count(); }
+	inline size_type column_count() const { return matrix.column_count(); }
+	inline double operator()(const size_type& row, const size_type& col) const { return matrix(row, col) * scalar; }
+	inline bool aliases(const void* destination) const { return matrix.aliases(destination); }
+
+private:
+	typename Operand<E>::type matrix;
+	double scalar;
+};
+
+//
+//
+//	Operators
+//
+//
+
+template <typename L, typename R>
+inline VectorBinary<L, R, Add> operator+(const VectorExpression<L>& left, const VectorExpression<R>& right) {
+	return VectorBinary<L, R, Add>(left.self(), right.self());
+}
+
+template <typename L, typename R>
+inline VectorBinary<L, R, Subtract> operator-(const VectorExpression<L>& left, const VectorExpression<R>& right) {
+	return VectorBinary<L, R, Subtract>(left.self(), right.self());
+}
+
+template <typename E>
+inline VectorScale<E> operator*(const VectorExpression<E>& vector, const double& scalar) {
+	return VectorScale<E>(vector.self(), scalar);
+}
+
+template <typename E>
+inline VectorScale<E> operator-(const VectorExpression<E>& vector) {
+	return VectorScale<E>(vector.self(), -1.0);
+}
+
+template <typename L, typename R>
+inline MatrixBinary<L, R, Add> operator+(const MatrixExpression<L>& left, const MatrixExpression<R>& right) {
+	return MatrixBinary<L, R, Add>(left.self(), right.self());
+}
+
+template <typename L, typename R>
+inline MatrixBinary<L, R, Subtract> operator-(const MatrixExpression<L>& left, const MatrixExpression<R>& right) {
+	return MatrixBinary<L, R, Subtract>(left.self(), right.self());
+}
+
+template <typename E>
+inline MatrixScale<E> operator*(const MatrixExpression<E>& matrix, const double& scalar) {
+	return MatrixScale<E>(matrix.self(), scalar);
+}
+
+#endif
@@ -4,6 +4,7 @@
 #define _USE_MATH_DEFINES
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <numeric>
 #include <cassert>
@@ -23,6 +24,11 @@ enum FillType {
 	RANDOM
 };
 
+enum PoolType {
+	MAX,
+	AVERAGE
+};
+
 //
 //
 //	Classes
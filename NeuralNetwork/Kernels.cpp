@@ -0,0 +1,41 @@
+#include "Kernels.h"
+
+void im2col(const double* image, const size_t& channels, const size_t& height, const size_t& width, const size_t& kernel_size, double* columns) {
+	const size_t output_height = height - kernel_size + 1;
+	const size_t output_width = width - kernel_size + 1;
+
+	// Row (c, ky, kx) of columns holds, for every output pixel, the input pixel under kernel position (ky, kx) of channel c
+	for (size_t c = 0; c < channels; ++c) {
+		for (size_t ky = 0; ky < kernel_size; ++ky) {
+			for (size_t kx = 0; kx < kernel_size; ++kx) {
+				double* column_row = columns + ((c * kernel_size + ky) * kernel_size + kx) * output_height * output_width;
+
+				for (size_t y = 0; y < output_height; ++y) {
+					const double* image_row = image + (c * height + y + ky) * width + kx;
+					std::copy(image_row, image_row + output_width, column_row + y * output_width);
+				}
+			}
+		}
+	}
+}
+
+void col2im(const double* columns, const size_t& channels, const size_t& height, const size_t& width, const size_t& kernel_size, double* image) {
+	const size_t output_height = height - kernel_size + 1;
+	const size_t output_width = width - kernel_size + 1;
+
+	for (size_t c = 0; c < channels; ++c) {
+		for (size_t ky = 0; ky < kernel_size; ++ky) {
+			for (size_t kx = 0; kx < kernel_size; ++kx) {
+				const double* column_row = columns + ((c * kernel_size + ky) * kernel_size + kx) * output_height * output_width;
+
+				for (size_t y = 0; y < output_height; ++y) {
+					double* image_row = image + (c * height + y + ky) * width + kx;
+
+					for (size_t x = 0; x < output_width; ++x) {
+						image_row[x] += column_row[y * output_width + x];
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,18 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+#include "Helpers.h"
+
+//
+//
+//	Convolution Kernels
+//
+//
+
+// Unrolls every kernel_size x kernel_size patch of a (channels x height x width) image into one column of a
+// (channels * kernel_size * kernel_size) x (output_height * output_width) matrix, so a valid convolution becomes one gemm
+void im2col(const double* image, const size_t& channels, const size_t& height, const size_t& width, const size_t& kernel_size, double* columns);
+
+// Inverse of im2col: adds each column entry back onto the image pixel it was copied from
+void col2im(const double* columns, const size_t& channels, const size_t& height, const size_t& width, const size_t& kernel_size, double* image);
+
+#endif
@@ -0,0 +1,229 @@
+#include "Layer.h"
+#include "Kernels.h"
+#include "Backend.h"
+
+//
+//
+//	DenseLayer
+//
+//
+
+DenseLayer::DenseLayer(const size_t& inputs, const size_t& outputs) : weights(outputs, inputs), biases(outputs), nabla_W(outputs, inputs), nabla_B(outputs) {
+	weights.fill(FillType::RANDOM);
+	biases.fill(FillType::RANDOM);
+}
+
+Vector DenseLayer::forward(const Vector& input) {
+	this->input = input;
+	return weights * input + biases;
+}
+
+Vector DenseLayer::backward(const Vector& output_gradient, const bool& needs_input_gradient) {
+	nabla_B = nabla_B + output_gradient;
+	nabla_W.add_outer_product(output_gradient, input);
+
+	if (!needs_input_gradient) {
+		return Vector();
+	}
+
+	return weights.transpose() * output_gradient;
+}
+
+void DenseLayer::update(const double& learning_constant, const double& regularisation_constant) {
+	weights = (weights * regularisation_constant) - (nabla_W * learning_constant);
+	biases = biases - (nabla_B * learning_constant);
+
+	nabla_W.fill(FillType::ZERO);
+	nabla_B.fill(FillType::ZERO);
+}
+
+//
+//
+//	ConvolutionLayer
+//
+//
+
+ConvolutionLayer::ConvolutionLayer(const size_t& channels, const size_t& height, const size_t& width, const size_t& filters, const size_t& kernel_size) :
+	channels(channels), height(height), width(width),
+	filters(filters), kernel_size(kernel_size),
+	output_height(height - kernel_size + 1), output_width(width - kernel_size + 1),
+	weights(filters * channels * kernel_size * kernel_size), biases(filters),
+	nabla_W(weights.size(), 0.0), nabla_B(filters, 0.0),
+	columns(channels * kernel_size * kernel_size * output_height * output_width) {
+
+	assert((kernel_size <= height) && (kernel_size <= width));
+
+	// Same scaling as Matrix::fill, with each filter seeing channels * kernel_size * kernel_size inputs
+	const double weight_std_dev = 1.0 / std::sqrt(static_cast<double>(channels * kernel_size * kernel_size));
+	for (size_t index = 0; index < weights.size(); ++index) {
+		weights[index] = Random::get_gaussian_distribution(0.0, weight_std_dev);
+	}
+
+	for (size_t index = 0; index < biases.size(); ++index) {
+		biases[index] = Random::get_gaussian_distribution(0.0, 1.0);
+	}
+}
+
+Vector ConvolutionLayer::forward(const Vector& input) {
+	assert(input.size() == input_size());
+
+	const size_t patch_size = channels * kernel_size * kernel_size;
+	const size_t pixel_count = output_height * output_width;
+
+	im2col(input.data(), channels, height, width, kernel_size, columns.data());
+
+	Vector output(output_size());
+	double* output_values = output.data();
+	for (size_t filter = 0; filter < filters; ++filter) {
+		std::fill(output_values + filter * pixel_count, output_values + (filter + 1) * pixel_count, biases[filter]);
+	}
+
+	// output (filters x pixels) += weights (filters x patch) * columns (patch x pixels)
+	Backend::get()->gemm(false, false, filters, pixel_count, patch_size, 1.0, weights.data(), patch_size, columns.data(), pixel_count, 1.0, output_values, pixel_count);
+
+	return output;
+}
+
+Vector ConvolutionLayer::backward(const Vector& output_gradient, const bool& needs_input_gradient) {
+	assert(output_gradient.size() == output_size());
+
+	const size_t patch_size = channels * kernel_size * kernel_size;
+	const size_t pixel_count = output_height * output_width;
+	const double* gradient_values = output_gradient.data();
+
+	// nabla_W (filters x patch) += output_gradient (filters x pixels) * columns^T (pixels x patch)
+	Backend::get()->gemm(false, true, filters, patch_size, pixel_count, 1.0, gradient_values, pixel_count, columns.data(), pixel_count, 1.0, nabla_W.data(), patch_size);
+
+	for (size_t filter = 0; filter < filters; ++filter) {
+		nabla_B[filter] += std::accumulate(gradient_values + filter * pixel_count, gradient_values + (filter + 1) * pixel_count, 0.0);
+	}
+
+	if (!needs_input_gradient) {
+		return Vector();
+	}
+
+	// column_gradient (patch x pixels) = weights^T (patch x filters) * output_gradient (filters x pixels)
+	std::vector<double> column_gradient(patch_size * pixel_count);
+	Backend::get()->gemm(true, false, patch_size, pixel_count, filters, 1.0, weights.data(), patch_size, gradient_values, pixel_count, 0.0, column_gradient.data(), pixel_count);
+
+	Vector input_gradient(input_size());
+	col2im(column_gradient.data(), channels, height, width, kernel_size, input_gradient.data());
+
+	return input_gradient;
+}
+
+void ConvolutionLayer::update(const double& learning_constant, const double& regularisation_constant) {
+	for (size_t index = 0; index < weights.size(); ++index) {
+		weights[index] = (weights[index] * regularisation_constant) - (nabla_W[index] * learning_constant);
+	}
+
+	for (size_t index = 0; index < biases.size(); ++index) {
+		biases[index] -= nabla_B[index] * learning_constant;
+	}
+
+	std::fill(nabla_W.begin(), nabla_W.end(), 0.0);
+	std::fill(nabla_B.begin(), nabla_B.end(), 0.0);
+}
+
+//
+//
+//	PoolingLayer
+//
+//
+
+PoolingLayer::PoolingLayer(const size_t& channels, const size_t& height, const size_t& width, const size_t& pool_size, const PoolType& type) :
+	channels(channels), height(height), width(width),
+	pool_size(pool_size),
+	output_height(height / pool_size), output_width(width / pool_size),
+	type(type),
+	max_indices(channels * output_height * output_width) {
+
+	assert((pool_size > 0) && (pool_size <= height) && (pool_size <= width));
+}
+
+Vector PoolingLayer::forward(const Vector& input) {
+	assert(input.size() == input_size());
+
+	const double* input_values = input.data();
+	const double window_area = static_cast<double>(pool_size * pool_size);
+
+	Vector output(output_size());
+	for (size_t c = 0; c < channels; ++c) {
+		for (size_t oy = 0; oy < output_height; ++oy) {
+			for (size_t ox = 0; ox < output_width; ++ox) {
+				const size_t output_index = (c * output_height + oy) * output_width + ox;
+				const size_t window_start = (c * height + oy * pool_size) * width + ox * pool_size;
+
+				size_t max_index = window_start;
+				double sum = 0.0;
+				for (size_t y = 0; y < pool_size; ++y) {
+					for (size_t x = 0; x < pool_size; ++x) {
+						const size_t index = window_start + y * width + x;
+						sum += input_values[index];
+
+						if (input_values[index] > input_values[max_index]) {
+							max_index = index;
+						}
+					}
+				}
+
+				max_indices[output_index] = max_index;
+				output.set(output_index, (type == PoolType::MAX) ? input_values[max_index] : sum / window_area);
+			}
+		}
+	}
+
+	return output;
+}
+
+Vector PoolingLayer::backward(const Vector& output_gradient, const bool& needs_input_gradient) {
+	// Nothing to learn, so the only work is routing the gradient back to the window inputs
+	if (!needs_input_gradient) {
+		return Vector();
+	}
+
+	const double window_area = static_cast<double>(pool_size * pool_size);
+
+	Vector input_gradient(input_size());
+	double* gradient_values = input_gradient.data();
+	for (size_t c = 0; c < channels; ++c) {
+		for (size_t oy = 0; oy < output_height; ++oy) {
+			for (size_t ox = 0; ox < output_width; ++ox) {
+				const size_t output_index = (c * output_height + oy) * output_width + ox;
+
+				if (type == PoolType::MAX) {
+					gradient_values[max_indices[output_index]] += output_gradient.at(output_index);
+					continue;
+				}
+
+				const size_t window_start = (c * height + oy * pool_size) * width + ox * pool_size;
+				for (size_t y = 0; y < pool_size; ++y) {
+					for (size_t x = 0; x < pool_size; ++x) {
+						gradient_values[window_start + y * width + x] += output_gradient.at(output_index) / window_area;
+					}
+				}
+			}
+		}
+	}
+
+	return input_gradient;
+}
+
+//
+//
+//	SigmoidLayer
+//
+//
+
+Vector SigmoidLayer::forward(const Vector& input) {
+	z_values = input;
+	return sigmoid(input);
+}
+
+Vector SigmoidLayer::backward(const Vector& output_gradient, const bool& needs_input_gradient) {
+	if (!needs_input_gradient) {
+		return Vector();
+	}
+
+	return Vector::hadamard(output_gradient, sigmoid_prime(z_values));
+}
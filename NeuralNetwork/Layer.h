@@ -0,0 +1,115 @@
+#ifndef LAYER_H
+#define LAYER_H
+#include "RequiresVector.h"
+#include "Matrix.h"
+
+//
+//
+//	Layers
+//
+//
+
+// Images are passed between layers as flat vectors of (channels x height x width), channel-major
+
+class Layer {
+public:
+	virtual ~Layer() {}
+
+	virtual size_t input_size() const = 0;
+	virtual size_t output_size() const = 0;
+
+	// forward caches what backward needs, so backward must follow the forward of the same image
+	virtual Vector forward(const Vector& input) = 0;
+
+	// Accumulates parameter gradients from dC/d(output) and returns dC/d(input) (empty if needs_input_gradient is false)
+	virtual Vector backward(const Vector& output_gradient, const bool& needs_input_gradient) = 0;
+
+	// Applies and clears the accumulated gradients
+	virtual void update(const double&, const double&) {}
+};
+
+
+class DenseLayer : public Layer {
+public:
+	DenseLayer(const size_t& inputs, const size_t& outputs);
+
+	inline size_t input_size() const { return weights.column_count(); }
+	inline size_t output_size() const { return weights.row_count(); }
+
+	Vector forward(const Vector& input);
+	Vector backward(const Vector& output_gradient, const bool& needs_input_gradient);
+	void update(const double& learning_constant, const double& regularisation_constant);
+
+private:
+	Matrix weights;
+	Vector biases;
+	Matrix nabla_W;
+	Vector nabla_B;
+
+	Vector input;
+};
+
+
+class ConvolutionLayer : public Layer {
+public:
+	// Valid (unpadded) convolution with stride 1
+	ConvolutionLayer(const size_t& channels, const size_t& height, const size_t& width, const size_t& filters, const size_t& kernel_size);
+
+	inline size_t input_size() const { return channels * height * width; }
+	inline size_t output_size() const { return filters * output_height * output_width; }
+
+	Vector forward(const Vector& input);
+	Vector backward(const Vector& output_gradient, const bool& needs_input_gradient);
+	void update(const double& learning_constant, const double& regularisation_constant);
+
+private:
+	size_t channels, height, width;
+	size_t filters, kernel_size;
+	size_t output_height, output_width;
+
+	std::vector<double> weights;	// filters x (channels * kernel_size * kernel_size)
+	std::vector<double> biases;		// filters
+	std::vector<double> nabla_W;
+	std::vector<double> nabla_B;
+
+	std::vector<double> columns;	// im2col of the last input
+};
+
+
+class PoolingLayer : public Layer {
+public:
+	// Non-overlapping pool_size x pool_size windows; trailing rows and columns that do not fill a window are dropped
+	PoolingLayer(const size_t& channels, const size_t& height, const size_t& width, const size_t& pool_size, const PoolType& type);
+
+	inline size_t input_size() const { return channels * height * width; }
+	inline size_t output_size() const { return channels * output_height * output_width; }
+
+	Vector forward(const Vector& input);
+	Vector backward(const Vector& output_gradient, const bool& needs_input_gradient);
+
+private:
+	size_t channels, height, width;
+	size_t pool_size;
+	size_t output_height, output_width;
+	PoolType type;
+
+	std::vector<size_t> max_indices;	// Input index chosen by each output of the last MAX forward
+};
+
+
+class SigmoidLayer : public Layer {
+public:
+	SigmoidLayer(const size_t& size) : size(size) {}
+
+	inline size_t input_size() const { return size; }
+	inline size_t output_size() const { return size; }
+
+	Vector forward(const Vector& input);
+	Vector backward(const Vector& output_gradient, const bool& needs_input_gradient);
+
+private:
+	size_t size;
+	Vector z_values;
+};
+
+#endif
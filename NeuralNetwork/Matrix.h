@@ -2,29 +2,67 @@
 #define MATRIX_H
 #include "Helpers.h"
 #include "Vector.h"
+#include "SparseVector.h"
+#include "Backend.h"
 
-class Matrix {
+#include <memory>
+
+class MatrixTranspose;
+
+class Matrix : public MatrixExpression<Matrix> {
 public:
-	typedef std::vector<std::vector<double>>::size_type size_type;
+	typedef std::vector<double>::size_type size_type;
 
 public:
-	Matrix() : values(0) {}
+	Matrix() : rows(0), columns(0), values(0) {}
 	Matrix(const Matrix::size_type& row_count, const Matrix::size_type& column_count);
 
+	// Evaluates an expression (see Expression.h) in a single loop
+	template <typename E>
+	Matrix(const MatrixExpression<E>& expression) : Matrix(expression.row_count(), expression.column_count()) { evaluate(expression); }
+
+	template <typename E>
+	Matrix& operator=(const MatrixExpression<E>& expression);
+
 	void fill(const FillType& fill);
 	double sum() const;
 
-	inline std::vector<double>& operator[](int index) { return values[index]; }
+	inline Matrix::size_type row_count() const { return rows; }
+	inline Matrix::size_type column_count() const { return columns; }
+	inline double at(const Matrix::size_type& row, const Matrix::size_type& col) const { assert((row < rows) && (col < columns)); return values[row * columns + col]; }
+	inline const double* data() const { return values.data(); }
+	inline const double* row(const Matrix::size_type& index) const { return values.data() + index * columns; }
+
+	inline double* operator[](const Matrix::size_type& index) { return values.data() + index * columns; }
+
+	inline double operator()(const Matrix::size_type& row, const Matrix::size_type& col) const { return values[row * columns + col]; }
+	inline bool aliases(const void*) const { return false; }	// Element (i, j) is only read when writing element (i, j)
+
+	MatrixTranspose transpose() const;
 
-	Matrix transpose() const;
+	void add_outer_product(const Vector& left, const Vector& right);
+	void add_outer_product(const Vector& left, const SparseVector& right);
 
-	Matrix operator+(const Matrix& other) const;
-	Matrix operator-(const Matrix& other) const;
-	Vector operator*(const Vector& vector) const;
-	Matrix operator*(const double& scalar) const;
+	template <typename L, typename R>
+	static MatrixBinary<L, R, Multiply> hadamard(const MatrixExpression<L>& m1, const MatrixExpression<R>& m2) {
+		return MatrixBinary<L, R, Multiply>(m1.self(), m2.self());
+	}
 
 private:
-	std::vector<std::vector<double>> values;
+	template <typename E>
+	void evaluate(const MatrixExpression<E>& expression) {
+		for (Matrix::size_type i = 0; i < rows; ++i) {
+			double* row_values = values.data() + i * columns;
+			for (Matrix::size_type j = 0; j < columns; ++j) {
+				row_values[j] = expression(i, j);
+			}
+		}
+	}
+
+private:
+	Matrix::size_type rows;
+	Matrix::size_type columns;
+	std::vector<double> values;
 };
 
 /*
@@ -33,9 +71,156 @@ private:
   [x, x, x],
   [x, x, x] ]
 
-Row Count = Number of inner arrays
-Column Count = Number of items in each inner array
+Row Count = Number of rows
+Column Count = Number of items in each row
+
+values holds the rows one after another (row-major), so element (i, j) is values[i * Column Count + j]
 
 */
 
-#endif
\ No newline at end of file
+template <typename E>
+Matrix& Matrix::operator=(const MatrixExpression<E>& expression) {
+	// An expression that reads this matrix out of order (like its transpose) is evaluated into new storage first
+	if (expression.aliases(this)) {
+		Matrix result(expression);
+		std::swap(rows, result.rows);
+		std::swap(columns, result.columns);
+		values.swap(result.values);
+		return *this;
+	}
+
+	if ((row_count() != expression.row_count()) || (column_count() != expression.column_count())) {
+		*this = Matrix(expression.row_count(), expression.column_count());
+	}
+
+	evaluate(expression);
+	return *this;
+}
+
+//
+//
+//	Matrix Expressions
+//
+//
+
+class MatrixTranspose : public MatrixExpression<MatrixTranspose> {
+public:
+	MatrixTranspose(const Matrix& matrix) : matrix(matrix) {}
+
+	inline size_type row_count() const { return matrix.column_count(); }
+	inline size_type column_count() const { return matrix.row_count(); }
+	inline double operator()(const size_type& row, const size_type& col) const { return matrix(col, row); }
+	inline bool aliases(const void* destination) const { return static_cast<const void*>(&matrix) == destination; }
+
+	// The matrix being transposed, read row by row in products
+	inline const Matrix& source() const { return matrix; }
+
+private:
+	const Matrix& matrix;
+};
+
+inline MatrixTranspose Matrix::transpose() const {
+	return MatrixTranspose(*this);
+}
+
+// Computed by the selected Backend in one gemv, written straight into the Vector the expression is assigned to once that
+// Vector binds its storage (see Expression.h). An unbound product falls back to one dot product per element.
+// Copies share the evaluated operand of a nested expression, so parents can hold the product by value for free.
+class MatrixVectorProduct : public VectorExpression<MatrixVectorProduct> {
+public:
+	MatrixVectorProduct(const Matrix& matrix, const Vector& vector) : matrix(matrix), vector(&vector), computed(nullptr) {
+		assert(matrix.column_count() == vector.size());
+	}
+
+	// The gemv needs contiguous input, so an expression operand is evaluated once here
+	template <typename E>
+	MatrixVectorProduct(const Matrix& matrix, const VectorExpression<E>& expression) :
+		matrix(matrix), evaluated(std::make_shared<const Vector>(expression)), vector(evaluated.get()), computed(nullptr) {
+		assert(matrix.column_count() == vector->size());
+	}
+
+	inline size_type size() const { return matrix.row_count(); }
+	inline bool aliases(const void* destination) const { return static_cast<const void*>(vector) == destination; }
+	inline bool reads(const void* destination) const { return static_cast<const void*>(vector) == destination; }
+
+	inline bool bind(double* destination) const {
+		assert(destination != vector->data());
+
+		Backend::get()->gemv(false, matrix.row_count(), matrix.column_count(), 1.0, matrix.data(), matrix.column_count(), vector->data(), 0.0, destination);
+		computed = destination;
+		return true;
+	}
+
+	inline double operator[](const size_type& index) const {
+		if (computed != nullptr) {
+			return computed[index];
+		}
+
+		const double* row_values = matrix.row(index);
+		const double* vector_values = vector->data();
+
+		double sum = 0.0;
+		for (size_type col = 0; col < vector->size(); ++col) {
+			sum += row_values[col] * vector_values[col];
+		}
+
+		return sum;
+	}
+
+private:
+	const Matrix& matrix;
+	std::shared_ptr<const Vector> evaluated;	// Owns the operand when it was an expression
+	const Vector* vector;
+	mutable const double* computed;				// Where bind wrote the product, if it has been bound
+};
+
+// Only gathers the columns matching non-zero entries of vector
+class MatrixSparseVectorProduct : public VectorExpression<MatrixSparseVectorProduct> {
+public:
+	MatrixSparseVectorProduct(const Matrix& matrix, const SparseVector& vector) : matrix(matrix), vector(vector) {
+		assert(matrix.column_count() == vector.size());
+	}
+
+	inline size_type size() const { return matrix.row_count(); }
+	inline bool aliases(const void*) const { return false; }
+	inline bool reads(const void*) const { return false; }
+	inline bool bind(double*) const { return false; }
+
+	inline double operator[](const size_type& index) const {
+		const double* row_values = matrix.row(index);
+
+		double sum = 0.0;
+		for (SparseVector::size_type position = 0; position < vector.non_zero_count(); ++position) {
+			sum += row_values[vector.index(position)] * vector.value(position);
+		}
+
+		return sum;
+	}
+
+private:
+	const Matrix& matrix;
+	const SparseVector& vector;
+};
+
+template <typename E>
+inline MatrixVectorProduct operator*(const Matrix& matrix, const VectorExpression<E>& vector) {
+	return MatrixVectorProduct(matrix, vector.self());
+}
+
+inline MatrixSparseVectorProduct operator*(const Matrix& matrix, const SparseVector& vector) {
+	return MatrixSparseVectorProduct(matrix, vector);
+}
+
+template <typename E>
+Vector operator*(const MatrixTranspose& transpose, const VectorExpression<E>& vector) {
+	const Matrix& matrix = transpose.source();
+	const Vector& evaluated = vector.self();
+	assert(matrix.row_count() == evaluated.size());
+
+	Vector result(matrix.column_count());
+	Backend::get()->gemv(true, matrix.row_count(), matrix.column_count(), 1.0, matrix.data(), matrix.column_count(), evaluated.data(), 0.0, result.data());
+
+	return result;
+}
+
+#endif
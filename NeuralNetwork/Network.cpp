@@ -11,43 +11,251 @@ Network::Network(const std::vector<size_t>& sizes, const NetworkConfig& config)
 		new_weight.fill(FillType::RANDOM);
 		weights[layer] = new_weight;
 	}
+
+	publish();
 }
 
-Vector Network::feedforward(Vector activations) const {
+Vector Network::feedforward(const SparseVector& input_activations) const {
 	// Returns the output of the network
 	assert(weights.size() == biases.size());
 
-	for (size_t layer = 1; layer < sizes.size(); ++layer) {
+	// The first layer only gathers the weight columns of non-zero pixels
+	Vector activations = sigmoid(weights.at(1) * input_activations + biases.at(1));
+
+	for (size_t layer = 2; layer < sizes.size(); ++layer) {
 		activations = sigmoid(weights.at(layer) * activations + biases.at(layer));
 	}
 
 	return activations;
 }
 
+Vector Network::unpruned_feedforward(Vector activations) const {
+	// Runs the weights saved at the start of prune, on a dense input so it can be timed against pruned_feedforward
+	assert(unpruned.weights.size() == sizes.size());
+
+	for (size_t layer = 1; layer < sizes.size(); ++layer) {
+		activations = sigmoid(unpruned.weights.at(layer) * activations + unpruned.biases.at(layer));
+	}
+
+	return activations;
+}
+
+Vector Network::pruned_feedforward(Vector activations) const {
+	// Runs the compressed weights built by prune on a dense input
+	assert(sparse_weights.size() == biases.size());
+
+	for (size_t layer = 1; layer < sizes.size(); ++layer) {
+		activations = sigmoid(sparse_weights.at(layer) * activations + biases.at(layer));
+	}
+
+	return activations;
+}
+
 void Network::train(std::vector<ImageTuple> training, const std::vector<ImageTuple>& test, const std::vector<ImageTuple>& validation) {
 	for (size_t epoch = 0; epoch < config.epochs; ++epoch) {
-		Random::shuffle<ImageTuple>(training);
-		const std::vector<std::vector<ImageTuple>> mini_batches = split_training_data(training, config.mini_batch_size);
-
-		for (size_t i = 0; i < mini_batches.size(); ++i) {
-			update_mini_batch(mini_batches.at(i), training.size());
-		}
+		train_epoch(training);
 
 		std::pair<size_t, double> training_evaluation = evaluate(training);
 		std::pair<size_t, double> validation_evaluation = evaluate(validation);
 
 		std::cout << "Epoch " << epoch + 1 << " of " << config.epochs << ": " << std::endl;
+		print_evaluation("Training", training_evaluation, training.size());
+		print_evaluation("Validation", validation_evaluation, validation.size());
+		std::cout << std::endl;
+	}
+
+	std::cout << "Finished" << std::endl;
+}
+
+void Network::prune(const PruneConfig& prune_config, std::vector<ImageTuple> training, const std::vector<ImageTuple>& validation) {
+	assert((prune_config.sparsity >= 0.0) && (prune_config.sparsity < 1.0) && (prune_config.iterations > 0));
 
-		std::cout << "\tTraining:" << std::endl;
-		std::cout << "\t\t" << training_evaluation.first << " / " << training.size() << "\t= " << 100.0 * training_evaluation.first / training.size() << "%" <<  std::endl;
-		std::cout << "\t\t" << training_evaluation.second << std::endl;
+	unpruned = NetworkSnapshot{ biases, weights };
 
-		std::cout << "\tValidation:" << std::endl;
-		std::cout << "\t\t" << validation_evaluation.first << " / " << validation.size() << "\t= " << 100.0 * validation_evaluation.first / validation.size() << "%" << std::endl;
-		std::cout << "\t\t" << validation_evaluation.second << std::endl << std::endl;
+	masks = std::vector<Matrix>(sizes.size());
+	for (size_t layer = 1; layer < sizes.size(); ++layer) {
+		masks[layer] = Matrix(sizes.at(layer), sizes.at(layer - 1));
 	}
 
-	std::cout << "Finished" << std::endl;
+	for (size_t iteration = 0; iteration < prune_config.iterations; ++iteration) {
+		// Sparsity grows linearly each iteration so fine-tuning can recover between steps
+		const double sparsity = prune_config.sparsity * static_cast<double>(iteration + 1) / static_cast<double>(prune_config.iterations);
+
+		for (size_t layer = 1; layer < sizes.size(); ++layer) {
+			std::vector<double> magnitudes;
+			for (size_t k = 0; k < sizes.at(layer); ++k) {
+				for (size_t j = 0; j < sizes.at(layer - 1); ++j) {
+					magnitudes.push_back(std::abs(weights.at(layer).at(k, j)));
+				}
+			}
+
+			// Weights strictly below the magnitude at the sparsity quantile are removed
+			const size_t pruned_count = static_cast<size_t>(sparsity * static_cast<double>(magnitudes.size()));
+			std::nth_element(magnitudes.begin(), magnitudes.begin() + pruned_count, magnitudes.end());
+			const double threshold = magnitudes.at(pruned_count);
+
+			for (size_t k = 0; k < sizes.at(layer); ++k) {
+				for (size_t j = 0; j < sizes.at(layer - 1); ++j) {
+					masks[layer][k][j] = (std::abs(weights.at(layer).at(k, j)) < threshold) ? 0.0 : 1.0;
+				}
+			}
+
+			weights[layer] = Matrix::hadamard(weights.at(layer), masks.at(layer));
+		}
+
+		for (size_t epoch = 0; epoch < prune_config.fine_tune_epochs; ++epoch) {
+			train_epoch(training);
+		}
+
+		std::pair<size_t, double> validation_evaluation = evaluate(validation);
+
+		std::cout << "Pruning step " << iteration + 1 << " of " << prune_config.iterations << " (" << 100.0 * sparsity << "% sparsity): " << std::endl;
+		print_evaluation("Validation", validation_evaluation, validation.size());
+		std::cout << std::endl;
+	}
+
+	sparse_weights = std::vector<SparseMatrix>(sizes.size());
+	for (size_t layer = 1; layer < sizes.size(); ++layer) {
+		sparse_weights[layer] = SparseMatrix(weights.at(layer));
+	}
+}
+
+void Network::report(const std::vector<ImageTuple>& data) const {
+	// Compares the network from before prune with the pruned one. Both run on the same dense input, so the difference in
+	// latency comes from the weights alone
+	assert((sparse_weights.size() == sizes.size()) && (unpruned.weights.size() == sizes.size()));
+
+	size_t unpruned_correct = 0;
+	size_t pruned_correct = 0;
+
+	const std::chrono::high_resolution_clock::time_point unpruned_start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < data.size(); ++i) {
+		if (get_highest_index(unpruned_feedforward(data.at(i).image_vector)) == get_highest_index(data.at(i).desired_output)) {
+			unpruned_correct++;
+		}
+	}
+
+	const std::chrono::high_resolution_clock::time_point pruned_start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < data.size(); ++i) {
+		if (get_highest_index(pruned_feedforward(data.at(i).image_vector)) == get_highest_index(data.at(i).desired_output)) {
+			pruned_correct++;
+		}
+	}
+
+	const std::chrono::high_resolution_clock::time_point pruned_end = std::chrono::high_resolution_clock::now();
+
+	size_t unpruned_size = 0;
+	size_t pruned_size = 0;
+	size_t weight_count = 0;
+	size_t non_zero_count = 0;
+	for (size_t layer = 1; layer < sizes.size(); ++layer) {
+		const size_t bias_size = sizes.at(layer) * sizeof(double);
+		unpruned_size += sizes.at(layer) * sizes.at(layer - 1) * sizeof(double) + bias_size;
+		pruned_size += sparse_weights.at(layer).memory_size() + bias_size;
+
+		weight_count += sizes.at(layer) * sizes.at(layer - 1);
+		non_zero_count += sparse_weights.at(layer).non_zero_count();
+	}
+
+	const double unpruned_latency = std::chrono::duration<double, std::micro>(pruned_start - unpruned_start).count() / static_cast<double>(data.size());
+	const double pruned_latency = std::chrono::duration<double, std::micro>(pruned_end - pruned_start).count() / static_cast<double>(data.size());
+
+	std::cout << "Pruned weights: " << weight_count - non_zero_count << " / " << weight_count << std::endl << std::endl;
+
+	std::cout << "\tUnpruned (dense weights):" << std::endl;
+	std::cout << "\t\t" << unpruned_correct << " / " << data.size() << "\t= " << 100.0 * unpruned_correct / data.size() << "%" << std::endl;
+	std::cout << "\t\t" << unpruned_size / 1024.0 << " KiB" << std::endl;
+	std::cout << "\t\t" << unpruned_latency << " us / image" << std::endl;
+
+	std::cout << "\tPruned (CSR weights):" << std::endl;
+	std::cout << "\t\t" << pruned_correct << " / " << data.size() << "\t= " << 100.0 * pruned_correct / data.size() << "%" << std::endl;
+	std::cout << "\t\t" << pruned_size / 1024.0 << " KiB" << std::endl;
+	std::cout << "\t\t" << pruned_latency << " us / image" << std::endl << std::endl;
+}
+
+void Network::learn(std::istream& stream, const StreamConfig& stream_config, const std::atomic<bool>& running) {
+	assert(stream_config.training_size > 0);
+
+	std::vector<ImageTuple> mini_batch;
+	size_t mini_batches_since_publish = 0;
+
+	std::string pending;
+	std::string line;
+	bool end_of_stream = false;
+	while (running.load() && !end_of_stream) {
+		if (!std::getline(stream, line) || stream.eof()) {
+			// The end of the stream may hold half of a line that is still being written
+			pending += line;
+			if (stream_config.follow && !stream.bad()) {
+				stream.clear();
+				std::this_thread::sleep_for(std::chrono::milliseconds(stream_config.poll_milliseconds));
+				continue;
+			}
+
+			// Without follow, an unterminated last line is still a sample
+			end_of_stream = true;
+			if (pending.empty()) {
+				continue;
+			}
+
+			line.clear();
+		}
+
+		line = pending + line;
+		pending.clear();
+
+		ImageTuple sample;
+		if (!parse_labeled_sample(line, sample)) {
+			std::cout << "Skipped malformed sample" << std::endl;
+			continue;
+		}
+
+		mini_batch.push_back(sample);
+
+		if (mini_batch.size() == config.mini_batch_size) {
+			update_mini_batch(mini_batch, stream_config.training_size);
+			mini_batch.clear();
+
+			if (++mini_batches_since_publish == stream_config.publish_interval) {
+				publish();
+				mini_batches_since_publish = 0;
+			}
+		}
+	}
+
+	if (!mini_batch.empty()) {
+		update_mini_batch(mini_batch, stream_config.training_size);
+	}
+
+	publish();
+}
+
+Vector Network::predict(const SparseVector& input_activations) const {
+	// Safe to call from any thread while train or learn runs; uses the last published weights
+	return snapshot.read([&](const NetworkSnapshot& published) {
+		Vector activations = sigmoid(published.weights.at(1) * input_activations + published.biases.at(1));
+
+		for (size_t layer = 2; layer < sizes.size(); ++layer) {
+			activations = sigmoid(published.weights.at(layer) * activations + published.biases.at(layer));
+		}
+
+		return activations;
+	});
+}
+
+void Network::publish() {
+	snapshot.publish(NetworkSnapshot{ biases, weights });
+}
+
+void Network::train_epoch(std::vector<ImageTuple>& training) {
+	Random::shuffle<ImageTuple>(training);
+	const std::vector<std::vector<ImageTuple>> mini_batches = split_training_data(training, config.mini_batch_size);
+
+	for_each_batch(mini_batches, [&](const std::vector<ImageTuple>& mini_batch) {
+		update_mini_batch(mini_batch, training.size());
+	});
+
+	publish();
 }
 
 std::pair<size_t, double> Network::evaluate(const std::vector<ImageTuple>& data) {
@@ -56,7 +264,7 @@ std::pair<size_t, double> Network::evaluate(const std::vector<ImageTuple>& data)
 
 	for (size_t i = 0; i < data.size(); ++i) {
 		size_t desired_output_value = get_highest_index(data.at(i).desired_output);
-		Vector actual_output = feedforward(data.at(i).image_vector);
+		Vector actual_output = feedforward(data.at(i).sparse_image);
 
 		if (desired_output_value == get_highest_index(actual_output)) {
 			correct++;
@@ -76,15 +284,9 @@ void Network::update_mini_batch(const std::vector<ImageTuple>& mini_batch, const
 		nabla_W[layer] = Matrix(sizes.at(layer), sizes.at(layer - 1));
 	}
 
+	// Each call accumulates its gradient directly into nabla_B and nabla_W
 	for (size_t i = 0; i < mini_batch.size(); ++i) {
-		std::pair<std::vector<Vector>, std::vector<Matrix>> delta_nablas = backprop(mini_batch.at(i));
-		std::vector<Vector> delta_nabla_B = delta_nablas.first;
-		std::vector<Matrix> delta_nabla_W = delta_nablas.second;
-
-		for (size_t layer = 1; layer < sizes.size(); ++layer) {
-			nabla_B[layer] = nabla_B.at(layer) + delta_nabla_B.at(layer);
-			nabla_W[layer] = nabla_W.at(layer) + delta_nabla_W.at(layer);
-		}
+		backprop(mini_batch.at(i), nabla_B, nabla_W);
 	}
 
 	const double learning_constant = config.eta / static_cast<double>(mini_batch.size());
@@ -95,47 +297,45 @@ void Network::update_mini_batch(const std::vector<ImageTuple>& mini_batch, const
 		const double regularisation_constant = (1.0 - (config.eta * config.lambda / static_cast<double>(training_size)));
 		weights[layer] = (weights.at(layer) * regularisation_constant) - (nabla_W.at(layer) * learning_constant);
 		biases[layer] = biases.at(layer) - (nabla_B.at(layer) * learning_constant);
-	}
-}
 
-std::pair<std::vector<Vector>, std::vector<Matrix>> Network::backprop(const ImageTuple& image) {
-	std::vector<Vector> nabla_B(sizes.size());
-	std::vector<Matrix> nabla_W(sizes.size());
-	for (size_t layer = 1; layer < sizes.size(); ++layer) {
-		nabla_B[layer] = Vector(sizes.at(layer));
-		nabla_W[layer] = Matrix(sizes.at(layer), sizes.at(layer - 1));
+		// Pruned weights stay at zero while fine-tuning
+		if (!masks.empty()) {
+			weights[layer] = Matrix::hadamard(weights.at(layer), masks.at(layer));
+		}
 	}
+}
 
-	// Step 1: Input
+void Network::backprop(const ImageTuple& image, std::vector<Vector>& nabla_B, std::vector<Matrix>& nabla_W) {
+	// Step 1: Input (the first layer reads image.sparse_image, so activations[0] is never filled)
 	std::vector<Vector> activations(sizes.size());
-	activations[0] = image.image_vector;
 
-	// Step 2: Feedforward
+	// Step 2: Feedforward (the first layer skips zero pixels)
 	std::vector<Vector> z_values(sizes.size());
 	for (size_t layer = 1; layer < sizes.size(); ++layer) {
-		z_values[layer] = weights.at(layer) * activations.at(layer - 1) + biases.at(layer);
+		if (layer == 1) {
+			z_values[layer] = weights.at(layer) * image.sparse_image + biases.at(layer);
+		} else {
+			z_values[layer] = weights.at(layer) * activations.at(layer - 1) + biases.at(layer);
+		}
+
 		activations[layer] = sigmoid(z_values.at(layer));
 	}
 
 	// Step 3: Output Error (Compute Delta Last (delta ^ L) and nabla_B (same thing))
 	std::vector<Vector> delta(sizes.size());
 	delta[sizes.size() - 1] = config.cost_function.bias_derivative(z_values.at(sizes.size() - 1), activations.at(sizes.size() - 1), image.desired_output);
-	nabla_B[sizes.size() - 1] = delta.at(sizes.size() - 1);
+	nabla_B[sizes.size() - 1] = nabla_B.at(sizes.size() - 1) + delta.at(sizes.size() - 1);
 
 	// Step 4: Backpropagate the Error
 	for (size_t layer = (sizes.size() - 2); layer > 0; --layer) {
 		delta[layer] = Vector::hadamard(weights.at(layer + 1).transpose() * delta.at(layer + 1), sigmoid_prime(z_values.at(layer)));
-		nabla_B[layer] = delta.at(layer);
+		nabla_B[layer] = nabla_B.at(layer) + delta.at(layer);
 	}
 
 	// Step 5: Output (Find nabla_W)
-	for (size_t layer = 1; layer < sizes.size(); ++layer) {
-		for (size_t k = 0; k < sizes.at(layer); ++k) {
-			for (size_t j = 0; j < sizes.at(layer - 1); ++j) {
-				nabla_W[layer][k][j] = activations.at(layer - 1).at(j) * delta.at(layer).at(k);
-			}
-		}
+	// Columns of the first layer for zero pixels have a zero gradient, so only the non-zero pixels are visited
+	nabla_W[1].add_outer_product(delta.at(1), image.sparse_image);
+	for (size_t layer = 2; layer < sizes.size(); ++layer) {
+		nabla_W[layer].add_outer_product(delta.at(layer), activations.at(layer - 1));
 	}
-
-	return std::pair<std::vector<Vector>, std::vector<Matrix>>(nabla_B, nabla_W);
 }
@@ -2,6 +2,11 @@
 #define NETWORK_H
 #include "RequiresVector.h"
 #include "Matrix.h"
+#include "SparseMatrix.h"
+#include "DoubleBuffer.h"
+#include "Augmenter.h"
+
+#include <memory>
 
 
 struct NetworkConfig {
@@ -13,24 +18,58 @@ struct NetworkConfig {
 	CostFunction cost_function;
 };
 
+struct StreamConfig {
+	size_t publish_interval;	// Mini-batches between published snapshots
+	bool follow;				// Wait for more samples at the end of the stream (like tail -f) instead of stopping
+	size_t poll_milliseconds;	// Wait between checks for new samples when following
+	size_t training_size;		// Scales weight decay as training.size() does offline, since the stream's length is unknown
+};
 
-class Network {
+struct NetworkSnapshot {
+	std::vector<Vector> biases;
+	std::vector<Matrix> weights;
+};
+
+struct PruneConfig {
+	double sparsity;			// Fraction of weights set to zero once pruning finishes
+	size_t iterations;			// Pruning steps taken to reach sparsity
+	size_t fine_tune_epochs;	// Epochs of retraining after each pruning step
+};
+
+
+class Network : public Augmentable {
 public:
 	Network(const std::vector<size_t>& sizes, const NetworkConfig& config);
 	void train(std::vector<ImageTuple> training, const std::vector<ImageTuple>& test, const std::vector<ImageTuple>& validation);
 
+	void prune(const PruneConfig& prune_config, std::vector<ImageTuple> training, const std::vector<ImageTuple>& validation);
+	void report(const std::vector<ImageTuple>& data) const;
+
+	void learn(std::istream& stream, const StreamConfig& stream_config, const std::atomic<bool>& running);
+	Vector predict(const SparseVector& input_activations) const;
+
 private:
-	Vector feedforward(Vector input_activations) const;
+	Vector feedforward(const SparseVector& input_activations) const;
+	Vector unpruned_feedforward(Vector input_activations) const;
+	Vector pruned_feedforward(Vector input_activations) const;
 	std::pair<size_t, double> evaluate(const std::vector<ImageTuple>& validation_data);
 	
+	void publish();
+	void train_epoch(std::vector<ImageTuple>& training);
 	void update_mini_batch(const std::vector<ImageTuple>& mini_batch, const size_t& training_size);
-	std::pair<std::vector<Vector>, std::vector<Matrix>> backprop(const ImageTuple& image);
+	void backprop(const ImageTuple& image, std::vector<Vector>& nabla_B, std::vector<Matrix>& nabla_W);
 	
 private:
 	NetworkConfig config;
 	std::vector<size_t> sizes;
 	std::vector<Vector> biases;
 	std::vector<Matrix> weights;
+
+	std::vector<Matrix> masks;					// Zero where a weight has been pruned, empty before pruning
+	std::vector<SparseMatrix> sparse_weights;	// Compressed weights built once pruning finishes
+	NetworkSnapshot unpruned;					// Weights and biases from before the first pruning step, the baseline for report
+
+	DoubleBuffer<NetworkSnapshot> snapshot;		// Weights read by predict, refreshed by publish
 };
 
 #endif
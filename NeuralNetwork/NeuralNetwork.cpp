@@ -1,5 +1,6 @@
 #include "Helpers.h"
 #include "Network.h"
+#include "ConvNetwork.h"
 #include "RequiresVector.h"
 
 
@@ -21,6 +22,132 @@ void run_network() {
 		Network network({ 28 * 28, 64, 64, 10 }, config);
 		network.train(training_data, test_data, validation_data);
 
+		PruneConfig prune_config{
+			0.9,			// Final Sparsity
+			3,				// Pruning Steps
+			2				// Fine-Tuning Epochs per Step
+		};
+
+		network.prune(prune_config, training_data, validation_data);
+		network.report(test_data);
+
+	} catch (const std::exception& exception) {
+		std::cout << exception.what() << std::endl;
+	}
+}
+
+void run_conv_network() {
+	try {
+		std::tuple<std::vector<ImageTuple>, std::vector<ImageTuple>, std::vector<ImageTuple>> all_data = load_data();
+		std::vector<ImageTuple> training_data = std::get<0>(all_data);
+		std::vector<ImageTuple> test_data = std::get<1>(all_data);
+		std::vector<ImageTuple> validation_data = std::get<2>(all_data);
+
+		NetworkConfig config{
+			0.001,			// Learning Rate (eta)
+			5.0,			// Regularisation Parameter (lambda)
+			30,				// Epoch Count
+			5,				// Mini-Batch Size
+			CrossEntropy	// Cost Function
+		};
+
+		// 1x28x28 -> conv 5x5 -> 8x24x24 -> max pool 2x2 -> 8x12x12 -> dense -> 10
+		ConvNetwork network(config);
+		network.add_layer(new ConvolutionLayer(1, 28, 28, 8, 5));
+		network.add_layer(new SigmoidLayer(8 * 24 * 24));
+		network.add_layer(new PoolingLayer(8, 24, 24, 2, PoolType::MAX));
+		network.add_layer(new DenseLayer(8 * 12 * 12, 10));
+		network.add_layer(new SigmoidLayer(10));
+
+		AugmentConfig augment_config{
+			2.0,			// Max Shift (pixels)
+			10.0,			// Max Rotation (degrees)
+			1.5,			// Elastic Alpha (RMS pixels)
+			4.0,			// Elastic Sigma (pixels)
+			10.0,			// Noise Std Dev
+			1234,			// Seed
+			0				// Threads (all)
+		};
+
+		network.enable_augmentation(augment_config);
+		network.train(training_data, test_data, validation_data);
+
+	} catch (const std::exception& exception) {
+		std::cout << exception.what() << std::endl;
+	}
+}
+
+void run_online(const std::string& stream_path) {
+	// Learns from samples appended to stream_path ("-" reads a pipe on stdin) and reports validation accuracy as it goes
+	try {
+		std::vector<ImageTuple> validation_data = load_validation_data();
+
+		NetworkConfig config{
+			0.001,			// Learning Rate (eta)
+			5.0,			// Regularisation Parameter (lambda)
+			0,				// Epoch Count (unused when streaming)
+			5,				// Mini-Batch Size
+			CrossEntropy	// Cost Function
+		};
+
+		const bool from_pipe = (stream_path == "-");
+		StreamConfig stream_config{
+			100,			// Mini-Batches per Snapshot
+			!from_pipe,		// Follow the file for new samples
+			200,			// Poll Interval (ms)
+			55000			// Nominal Training Set Size
+		};
+
+		std::ifstream stream_file;
+		if (!from_pipe) {
+			stream_file.open(stream_path);
+			if (!stream_file.is_open()) {
+				throw std::runtime_error("Failed to open " + stream_path);
+			}
+		}
+
+		std::istream& stream = from_pipe ? std::cin : stream_file;
+
+		Network network({ 28 * 28, 64, 64, 10 }, config);
+		std::atomic<bool> running(true);
+		std::atomic<bool> learning(true);
+
+		std::thread learner([&]() {
+			network.learn(stream, stream_config, running);
+			learning.store(false);
+		});
+
+		// Predictions only read published snapshots, so they never wait for the learner
+		std::thread reporter([&]() {
+			while (learning.load()) {
+				for (size_t waited = 0; (waited < 50) && learning.load(); ++waited) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(100));
+				}
+
+				size_t correct = 0;
+				for (size_t i = 0; i < validation_data.size(); ++i) {
+					if (get_highest_index(network.predict(validation_data.at(i).sparse_image)) == get_highest_index(validation_data.at(i).desired_output)) {
+						correct++;
+					}
+				}
+
+				std::cout << "Validation: " << correct << " / " << validation_data.size() << "\t= " << 100.0 * correct / validation_data.size() << "%" << std::endl;
+			}
+		});
+
+		// A followed file never ends by itself, so learning stops when Enter is pressed
+		if (!from_pipe) {
+			std::cout << "Press Enter to stop learning" << std::endl;
+
+			std::string line;
+			std::getline(std::cin, line);
+			running.store(false);
+		}
+
+		learner.join();
+		reporter.join();
+		std::cout << "Finished" << std::endl;
+
 	} catch (const std::exception& exception) {
 		std::cout << exception.what() << std::endl;
 	}
@@ -30,7 +157,18 @@ int main(int argc, char* argv[]) {
 	if (argc < 1) { std::cout << "Less than one argument? Idk how this happened" << std::endl; return EXIT_FAILURE; }
 	FileSystem::set(argv[0]);
 
-	run_network();
+	if ((argc > 1) && (std::string(argv[1]) == "--check-backends")) {
+		// Compares every compute backend against the reference loops; set NN_BACKEND to choose the one used for training
+		return Backend::cross_check(1e-9) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if ((argc > 2) && (std::string(argv[1]) == "--online")) {
+		run_online(argv[2]);
+	} else if ((argc > 1) && (std::string(argv[1]) == "--conv")) {
+		run_conv_network();
+	} else {
+		run_network();
+	}
 
 	std::cin.get();
     return EXIT_SUCCESS;
@@ -1,10 +1,13 @@
 #ifndef REQUIRESVECTOR_H
 #define REQUIRESVECTOR_H
 #include "Vector.h"
+#include "SparseVector.h"
 
 #include <fstream>
+#include <sstream>
 
-static Vector sigmoid_prime(const Vector& x);
+template <typename E>
+static VectorApply<E, &sigmoid_prime> sigmoid_prime(const VectorExpression<E>& x);
 
 //
 //
@@ -63,28 +66,32 @@ static const CostFunction CrossEntropy{ CEE::function, CEE::delta };
 struct ImageTuple {
 	Vector image_vector;
 	Vector desired_output;
+	SparseVector sparse_image;	// Non-zero pixels of image_vector
 };
 
-static Vector apply(const Vector& x, double (*func)(const double&)) {
-	Vector result(x.size());
-	for (Vector::size_type index = 0; index < x.size(); ++index) {
-		result.set(index, func(x.at(index)));
-	}
-
-	return result;
+static ImageTuple make_image_tuple(const Vector& image_vector, const Vector& desired_output) {
+	return ImageTuple{ image_vector, desired_output, SparseVector(image_vector) };
+}
 
+// Applies Function to each element as part of the surrounding expression
+template <double (*Function)(const double&), typename E>
+static VectorApply<E, Function> apply(const VectorExpression<E>& x) {
+	return VectorApply<E, Function>(x.self());
 }
 
-static Vector sigmoid(const Vector& x) {
-	return apply(x, &sigmoid);
+template <typename E>
+static VectorApply<E, &sigmoid> sigmoid(const VectorExpression<E>& x) {
+	return apply<&sigmoid>(x);
 }
 
-static Vector sigmoid_prime(const Vector& x) {
-	return apply(x, &sigmoid_prime);
+template <typename E>
+static VectorApply<E, &sigmoid_prime> sigmoid_prime(const VectorExpression<E>& x) {
+	return apply<&sigmoid_prime>(x);
 }
 
-static Vector ln(const Vector& x) {
-	return apply(x, &ln);
+template <typename E>
+static VectorApply<E, &ln> ln(const VectorExpression<E>& x) {
+	return apply<&ln>(x);
 }
 
 static std::vector<std::vector<ImageTuple>> split_training_data(const std::vector<ImageTuple>& training_data, const std::vector<ImageTuple>::size_type& mini_batch_size) {
@@ -102,6 +109,13 @@ static size_t get_highest_index(const Vector& vector) {
 	return std::distance(vector_values.begin(), std::max_element(vector_values.begin(), vector_values.end()));
 }
 
+static void print_evaluation(const std::string& name, const std::pair<size_t, double>& evaluation, const size_t& data_size) {
+	// Prints the correct count, accuracy and cost returned by evaluate
+	std::cout << "\t" << name << ":" << std::endl;
+	std::cout << "\t\t" << evaluation.first << " / " << data_size << "\t= " << 100.0 * evaluation.first / data_size << "%" << std::endl;
+	std::cout << "\t\t" << evaluation.second << std::endl;
+}
+
 static std::vector<Vector> load_image_data(const std::string& file_name) {
 	std::fstream image_file(FileSystem::get_directory() + file_name, std::ios::in | std::ios::binary);
 	if (!image_file.is_open()) {
@@ -173,27 +187,62 @@ static std::vector<Vector> load_label_data(const std::string& file_name) {
 	return images;
 }
 
-static std::tuple<std::vector<ImageTuple>, std::vector<ImageTuple>, std::vector<ImageTuple>> load_data() {
-	std::vector<Vector> training_image_vectors = load_image_data("training_images");
-	std::cout << "Loaded training image vectors" << std::endl;
+// A streamed sample is one line of text: the label followed by 28 * 28 pixel values (0 - 255), separated by whitespace
+static bool parse_labeled_sample(const std::string& line, ImageTuple& sample) {
+	std::istringstream line_stream(line);
 
-	std::vector<Vector> training_label_vectors = load_label_data("training_labels");
-	std::cout << "Loaded training label vectors" << std::endl;
+	unsigned int label;
+	if (!(line_stream >> label) || (label >= 10)) {
+		return false;
+	}
+
+	Vector image_vector(28 * 28);
+	for (Vector::size_type pixel = 0; pixel < image_vector.size(); ++pixel) {
+		double value;
+		if (!(line_stream >> value)) {
+			return false;
+		}
+
+		image_vector.set(pixel, value);
+	}
 
+	Vector desired_output(10);
+	desired_output.set(label, 1.0);
+
+	sample = make_image_tuple(image_vector, desired_output);
+	return true;
+}
+
+static std::vector<ImageTuple> load_validation_data() {
 	std::vector<Vector> validation_image_vectors = load_image_data("validation_images");
 	std::cout << "Loaded validation image vectors" << std::endl;
 
 	std::vector<Vector> validation_label_vectors = load_label_data("validation_labels");
 	std::cout << "Loaded validation label vectors" << std::endl << std::endl;
 
-	assert(training_image_vectors.size() == training_label_vectors.size());
 	assert(validation_image_vectors.size() == validation_label_vectors.size());
 
+	std::vector<ImageTuple> validation_data;
+	for (size_t i = 0; i < validation_image_vectors.size(); ++i) {
+		validation_data.push_back(make_image_tuple(validation_image_vectors.at(i), validation_label_vectors.at(i)));
+	}
+
+	return validation_data;
+}
+
+static std::tuple<std::vector<ImageTuple>, std::vector<ImageTuple>, std::vector<ImageTuple>> load_data() {
+	std::vector<Vector> training_image_vectors = load_image_data("training_images");
+	std::cout << "Loaded training image vectors" << std::endl;
+
+	std::vector<Vector> training_label_vectors = load_label_data("training_labels");
+	std::cout << "Loaded training label vectors" << std::endl;
+
+	assert(training_image_vectors.size() == training_label_vectors.size());
+
 	std::vector<ImageTuple> training_data;
 	std::vector<ImageTuple> test_data;
-	std::vector<ImageTuple> validation_data;
 	for (size_t i = 0; i < training_image_vectors.size(); ++i) {
-		ImageTuple image_tuple = { training_image_vectors.at(i), training_label_vectors.at(i) };
+		ImageTuple image_tuple = make_image_tuple(training_image_vectors.at(i), training_label_vectors.at(i));
 		if (i < 55000) {
 			training_data.push_back(image_tuple);
 		} else {
@@ -201,11 +250,7 @@ static std::tuple<std::vector<ImageTuple>, std::vector<ImageTuple>, std::vector<
 		}
 	}
 
-	for (size_t i = 0; i < validation_image_vectors.size(); ++i) {
-		validation_data.push_back({ validation_image_vectors.at(i), validation_label_vectors.at(i) });
-	}
-
-	return std::make_tuple(training_data, test_data, validation_data);
+	return std::make_tuple(training_data, test_data, load_validation_data());
 }
 
 #endif
@@ -0,0 +1,39 @@
+#include "SparseMatrix.h"
+
+SparseMatrix::SparseMatrix(const Matrix& dense) : column_count(dense.column_count()), row_offsets(1, 0) {
+	for (Matrix::size_type row = 0; row < dense.row_count(); ++row) {
+		for (Matrix::size_type col = 0; col < dense.column_count(); ++col) {
+			if (dense.at(row, col) != 0.0) {
+				column_indices.push_back(col);
+				values.push_back(dense.at(row, col));
+			}
+		}
+
+		row_offsets.push_back(values.size());
+	}
+}
+
+SparseMatrix::size_type SparseMatrix::memory_size() const {
+	return
+		values.size() * sizeof(double) +
+		column_indices.size() * sizeof(SparseMatrix::size_type) +
+		row_offsets.size() * sizeof(SparseMatrix::size_type);
+}
+
+Vector SparseMatrix::operator*(const Vector& vector) const {
+	assert(column_count == vector.size());
+
+	const double* vector_values = vector.data();
+
+	Vector result(row_offsets.size() - 1);
+	for (SparseMatrix::size_type row = 0; row + 1 < row_offsets.size(); ++row) {
+		double sum = 0.0;
+		for (SparseMatrix::size_type position = row_offsets[row]; position < row_offsets[row + 1]; ++position) {
+			sum += values[position] * vector_values[column_indices[position]];
+		}
+
+		result.set(row, sum);
+	}
+
+	return result;
+}
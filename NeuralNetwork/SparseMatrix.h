@@ -0,0 +1,41 @@
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+#include "Matrix.h"
+
+class SparseMatrix {
+public:
+	typedef std::vector<double>::size_type size_type;
+
+public:
+	SparseMatrix() : column_count(0) {}
+	SparseMatrix(const Matrix& dense);
+
+	inline SparseMatrix::size_type non_zero_count() const { return values.size(); }
+	SparseMatrix::size_type memory_size() const;
+
+	Vector operator*(const Vector& vector) const;
+
+private:
+	SparseMatrix::size_type column_count;
+	std::vector<SparseMatrix::size_type> row_offsets;
+	std::vector<SparseMatrix::size_type> column_indices;
+	std::vector<double> values;
+};
+
+/*
+
+Compressed sparse row (CSR) storage of a matrix:
+
+dense          = [ [0, 5, 0],
+                   [0, 0, 0],
+                   [2, 0, 3] ]
+
+row_offsets    = [0, 1, 1, 3]
+column_indices = [1, 0, 2]
+values         = [5, 2, 3]
+
+The non-zero entries of row r are at positions row_offsets[r] to row_offsets[r + 1] - 1
+
+*/
+
+#endif
@@ -0,0 +1,10 @@
+#include "SparseVector.h"
+
+SparseVector::SparseVector(const Vector& dense) : dimension(dense.size()) {
+	for (SparseVector::size_type index = 0; index < dense.size(); ++index) {
+		if (dense.at(index) != 0.0) {
+			indices.push_back(index);
+			values.push_back(dense.at(index));
+		}
+	}
+}
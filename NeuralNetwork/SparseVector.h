@@ -0,0 +1,34 @@
+#ifndef SPARSEVECTOR_H
+#define SPARSEVECTOR_H
+#include "Vector.h"
+
+class SparseVector {
+public:
+	typedef std::vector<double>::size_type size_type;
+
+public:
+	SparseVector() : dimension(0) {}
+	SparseVector(const Vector& dense);
+
+	inline SparseVector::size_type size() const { return dimension; }
+	inline SparseVector::size_type non_zero_count() const { return values.size(); }
+	inline SparseVector::size_type index(const SparseVector::size_type& position) const { return indices[position]; }
+	inline double value(const SparseVector::size_type& position) const { return values[position]; }
+
+private:
+	SparseVector::size_type dimension;
+	std::vector<SparseVector::size_type> indices;
+	std::vector<double> values;
+};
+
+/*
+
+Only the non-zero entries of a dense vector are stored (a single CSR row):
+
+dense   = [0, 0, 7, 0, 3]
+indices = [2, 4]
+values  = [7, 3]
+
+*/
+
+#endif
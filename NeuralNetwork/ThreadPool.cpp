@@ -0,0 +1,78 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(const size_t& thread_count) : task(nullptr), task_count(0), next_task(0), generation(0), busy(0), stopping(false) {
+	for (size_t thread = 1; thread < thread_count; ++thread) {
+		workers.push_back(std::thread(&ThreadPool::work, this));
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	wake.notify_all();
+	for (size_t thread = 0; thread < workers.size(); ++thread) {
+		workers[thread].join();
+	}
+}
+
+void ThreadPool::run(const size_t& task_count, const std::function<void(const size_t&)>& task) {
+	std::unique_lock<std::mutex> run_lock(run_mutex, std::try_to_lock);
+	if (workers.empty() || !run_lock.owns_lock()) {
+		for (size_t index = 0; index < task_count; ++index) {
+			task(index);
+		}
+
+		return;
+	}
+
+	{
+		// A worker that joined the last generation after it finished must leave before next_task is reset under it
+		std::unique_lock<std::mutex> lock(mutex);
+		finished.wait(lock, [this]() { return busy == 0; });
+
+		this->task = &task;
+		this->task_count = task_count;
+		next_task = 0;
+		generation++;
+	}
+
+	wake.notify_all();
+
+	for (size_t index = next_task++; index < task_count; index = next_task++) {
+		task(index);
+	}
+
+	// Every task has been claimed, so once the workers holding one have left they have all finished
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this]() { return busy == 0; });
+}
+
+void ThreadPool::work() {
+	size_t seen_generation = 0;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [&]() { return stopping || (generation != seen_generation); });
+		if (stopping) {
+			return;
+		}
+
+		seen_generation = generation;
+		const std::function<void(const size_t&)>* current_task = task;
+		const size_t current_task_count = task_count;
+		busy++;
+		lock.unlock();
+
+		for (size_t index = next_task++; index < current_task_count; index = next_task++) {
+			(*current_task)(index);
+		}
+
+		lock.lock();
+		if (--busy == 0) {
+			finished.notify_all();
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads started once and reused, so splitting a product between threads costs a wake-up
+// rather than creating and joining threads on every call.
+// The calling thread takes part in run, so a pool of thread_count threads starts thread_count - 1 workers.
+class ThreadPool {
+public:
+	ThreadPool(const ThreadPool& other) = delete;
+	ThreadPool& operator=(const ThreadPool& other) = delete;
+
+	ThreadPool(const size_t& thread_count);
+	~ThreadPool();
+
+	// Threads available to run, including the caller
+	inline size_t size() const { return workers.size() + 1; }
+
+	// Calls task(index) for every index in [0, task_count) and returns once they have all finished.
+	// Runs everything on the calling thread if the pool is already busy with another run (another caller, or a task
+	// that itself calls run).
+	void run(const size_t& task_count, const std::function<void(const size_t&)>& task);
+
+private:
+	void work();
+
+private:
+	std::vector<std::thread> workers;
+	std::mutex run_mutex;								// Held for the whole of each run
+
+	std::mutex mutex;									// Guards everything below except next_task
+	std::condition_variable wake;						// Signals a new generation or shutdown to the workers
+	std::condition_variable finished;					// Signals busy dropping to zero
+	const std::function<void(const size_t&)>* task;
+	size_t task_count;
+	std::atomic<size_t> next_task;
+	size_t generation;									// Incremented by each run so workers can tell it from the last
+	size_t busy;										// Workers that have joined the current generation and not left it
+	bool stopping;
+};
+
+#endif
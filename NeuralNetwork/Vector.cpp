@@ -19,58 +19,6 @@ void Vector::fill(const FillType& fill) {
 	}
 }
 
-double Vector::magnitude() const {
-	double sum_of_squares = 0.0;
-
-	for (Vector::size_type index = 0; index < this->values.size(); ++index) {
-		sum_of_squares += this->values.at(index) * this->values.at(index);
-	}
-
-	return std::sqrt(sum_of_squares);
-}
-
-Vector Vector::operator+(const Vector& other) const {
-	assert(this->values.size() == other.values.size());
-
-	Vector result(this->values.size());
-	for (Vector::size_type index = 0; index < this->values.size(); ++index) {
-		result.set(index, this->values.at(index) + other.values.at(index));
-	}
-
-	return result;
-}
-
-Vector Vector::operator-(const Vector& other) const {
-	assert(this->values.size() == other.values.size());
-
-	Vector result(this->values.size());
-	for (Vector::size_type index = 0; index < this->values.size(); ++index) {
-		result.set(index, this->values.at(index) - other.values.at(index));
-	}
-
-	return result;
-}
-
-Vector Vector::operator*(const double& scalar) const {
-	assert(this->values.size() > 0);
-
-	Vector result(this->values.size());
-	for (Vector::size_type index = 0; index < this->values.size(); ++index) {
-		result.set(index, this->values.at(index) * scalar);
-	}
-
-	return result;
-}
-
-Vector Vector::operator-() const {
-	Vector result(this->values.size());
-	for (Vector::size_type index = 0; index < this->values.size(); ++index) {
-		result.set(index, -this->values.at(index));
-	}
-
-	return result;
-}
-
 double Vector::dot(const std::vector<double>& v1, const std::vector<double>& v2) {
 	assert(v1.size() == v2.size());
 	
@@ -81,14 +29,3 @@ double Vector::dot(const std::vector<double>& v1, const std::vector<double>& v2)
 
 	return result;
 }
-
-Vector Vector::hadamard(const Vector& v1, const Vector& v2) {
-	assert(v1.values.size() == v2.values.size());
-
-	Vector result(v1.values.size());
-	for (Vector::size_type index = 0; index < v1.values.size(); ++index) {
-		result.set(index, v1.values.at(index) * v2.values.at(index));
-	}
-
-	return result;
-}
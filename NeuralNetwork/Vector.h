@@ -2,8 +2,9 @@
 #define VECTOR_H
 #include <vector>
 #include "Helpers.h"
+#include "Expression.h"
 
-class Vector {
+class Vector : public VectorExpression<Vector> {
 public:
 	typedef std::vector<double>::size_type size_type;
 
@@ -11,24 +12,64 @@ public:
 	Vector() : values(0) {}
 	Vector(const Vector::size_type& size);
 
+	// Evaluates an expression (see Expression.h) in a single loop
+	template <typename E>
+	Vector(const VectorExpression<E>& expression) : values(expression.size()) { expression.bind(values.data()); evaluate(expression); }
+
+	template <typename E>
+	Vector& operator=(const VectorExpression<E>& expression);
+
 	inline Vector::size_type size() const { return values.size(); }
 	inline std::vector<double> to_vector() const { return values; }
+	inline double* data() { return values.data(); }
+	inline const double* data() const { return values.data(); }
 	inline double at(const Vector::size_type& index) const { return values.at(index); }
 	inline void set(const Vector::size_type& index, const double& value) { values[index] = value; }
 
-	void fill(const FillType& fill);
-	double magnitude() const;
+	inline double operator[](const Vector::size_type& index) const { return values[index]; }
+	inline bool aliases(const void*) const { return false; }	// Element i is only read when writing element i
+	inline bool reads(const void* destination) const { return this == destination; }
+	inline bool bind(double*) const { return false; }
 
-	Vector operator+(const Vector& other) const;
-	Vector operator-(const Vector& other) const;
-	Vector operator*(const double& scalar) const;
-	Vector operator-() const;
+	void fill(const FillType& fill);
 
 	static double dot(const std::vector<double>& v1, const std::vector<double>& v2);
-	static Vector hadamard(const Vector& v1, const Vector& v2);
+
+	template <typename L, typename R>
+	static VectorBinary<L, R, Multiply> hadamard(const VectorExpression<L>& v1, const VectorExpression<R>& v2) {
+		return VectorBinary<L, R, Multiply>(v1.self(), v2.self());
+	}
+
+private:
+	template <typename E>
+	void evaluate(const VectorExpression<E>& expression) {
+		for (Vector::size_type index = 0; index < values.size(); ++index) {
+			values[index] = expression[index];
+		}
+	}
 
 private:
 	std::vector<double> values;
 };
 
+template <typename E>
+Vector& Vector::operator=(const VectorExpression<E>& expression) {
+	// An expression that reads this vector out of order (like a matrix product) is evaluated into new storage first
+	if (expression.aliases(this)) {
+		Vector result(expression);
+		values.swap(result.values);
+		return *this;
+	}
+
+	values.resize(expression.size());
+
+	// A matrix product can only write into this vector if nothing else in the expression still reads its old values
+	if (!expression.reads(this)) {
+		expression.bind(values.data());
+	}
+
+	evaluate(expression);
+	return *this;
+}
+
 #endif